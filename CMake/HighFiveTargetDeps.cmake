@@ -37,6 +37,22 @@ if(NOT TARGET libdeps)
   target_link_libraries(libdeps INTERFACE ${HDF5_LIBRARIES})
   target_compile_definitions(libdeps INTERFACE ${HDF5_DEFINITIONS})
 
+  # Threads, started by e.g. repack, forEachChunk and AsyncLogSink
+  find_package(Threads REQUIRED)
+  target_link_libraries(libdeps INTERFACE Threads::Threads)
+
+  # shm_open, used by SharedBlockCache, is in librt before glibc 2.34
+  if(UNIX AND NOT APPLE)
+    include(CheckSymbolExists)
+    check_symbol_exists(shm_open "sys/mman.h" HIGHFIVE_HAS_SHM_OPEN)
+    if(NOT HIGHFIVE_HAS_SHM_OPEN)
+      find_library(HIGHFIVE_RT_LIBRARY rt)
+      if(HIGHFIVE_RT_LIBRARY)
+        target_link_libraries(libdeps INTERFACE ${HIGHFIVE_RT_LIBRARY})
+      endif()
+    endif()
+  endif()
+
   # Boost
   if(HIGHFIVE_USE_BOOST)
     if(NOT DEFINED Boost_NO_BOOST_CMAKE)
@@ -104,6 +120,16 @@ if(NOT TARGET libdeps)
     target_compile_definitions(libdeps INTERFACE H5_USE_OPENCV)
   endif()
 
+  # zlib
+  if(HIGHFIVE_USE_ZLIB)
+    if (NOT ZLIB_INCLUDE_DIRS)
+      find_package(ZLIB REQUIRED)
+    endif()
+    target_include_directories(libdeps SYSTEM INTERFACE ${ZLIB_INCLUDE_DIRS})
+    target_link_libraries(libdeps INTERFACE ${ZLIB_LIBRARIES})
+    target_compile_definitions(libdeps INTERFACE H5_USE_ZLIB)
+  endif()
+
   # MPI
   if(HIGHFIVE_PARALLEL_HDF5 OR HDF5_IS_PARALLEL)
     find_package(MPI REQUIRED)
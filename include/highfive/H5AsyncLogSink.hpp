@@ -0,0 +1,186 @@
+/*
+ *  Copyright (c), 2023, Blue Brain Project - EPFL
+ *
+ *  Distributed under the Boost Software License, Version 1.0.
+ *    (See accompanying file LICENSE_1_0.txt or copy at
+ *          http://www.boost.org/LICENSE_1_0.txt)
+ *
+ */
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "H5Utility.hpp"
+
+namespace HighFive {
+
+///
+/// \brief A logging callback which hands the messages to a background thread.
+///
+/// The default callback writes every message to `std::clog` and flushes it,
+/// on the thread which logs. With this sink, logging only appends the message
+/// to a lock-free queue; a background thread passes the queued messages to
+/// `downstream` every `interval`, by default writing them to `std::clog` with a
+/// single flush per batch.
+///
+///     auto sink = std::make_shared<AsyncLogSink>();
+///     register_logging_callback(sink->callback());
+///
+/// The callback keeps the queue alive, not the thread: once the sink is
+/// destroyed, the remaining messages are passed on and later ones are passed to
+/// `downstream` directly. `flush` passes on the queued messages immediately.
+///
+class AsyncLogSink {
+  public:
+    explicit AsyncLogSink(Logger::callback_type downstream = nullptr,
+                          std::chrono::milliseconds interval = std::chrono::milliseconds(50))
+        : _state(std::make_shared<State>(std::move(downstream)))
+        , _interval(interval)
+        , _thread([this]() { run(); }) {}
+
+    AsyncLogSink(const AsyncLogSink&) = delete;
+    AsyncLogSink& operator=(const AsyncLogSink&) = delete;
+
+    ~AsyncLogSink() {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stop = true;
+        }
+        _wakeup.notify_one();
+        _thread.join();
+
+        std::lock_guard<std::mutex> lock(_state->drain_mutex);
+        _state->stopped = true;
+        _state->drain();
+    }
+
+    /// \brief The callback to register with `register_logging_callback`.
+    Logger::callback_type callback() const {
+        auto state = _state;
+        return [state](LogSeverity severity,
+                       const std::string& message,
+                       const std::string& file,
+                       int line) { state->push(severity, message, file, line); };
+    }
+
+    /// \brief Pass the queued messages on, on the calling thread.
+    void flush() {
+        std::lock_guard<std::mutex> lock(_state->drain_mutex);
+        _state->drain();
+    }
+
+  private:
+    struct Record {
+        LogSeverity severity;
+        std::string message;
+        std::string file;
+        int line;
+        Record* next;
+    };
+
+    struct State {
+        explicit State(Logger::callback_type downstream_)
+            : downstream(std::move(downstream_)) {}
+
+        ~State() {
+            drain();
+        }
+
+        void push(LogSeverity severity,
+                  const std::string& message,
+                  const std::string& file,
+                  int line) {
+            if (stopped.load(std::memory_order_acquire)) {
+                std::lock_guard<std::mutex> lock(drain_mutex);
+                write(severity, message, file, line);
+                flush_clog();
+                return;
+            }
+
+            auto record = new Record{severity, message, file, line, nullptr};
+            record->next = head.load(std::memory_order_relaxed);
+            while (!head.compare_exchange_weak(record->next,
+                                               record,
+                                               std::memory_order_release,
+                                               std::memory_order_relaxed)) {
+            }
+        }
+
+        // Requires `drain_mutex`, except on destruction.
+        void drain() {
+            Record* records = head.exchange(nullptr, std::memory_order_acquire);
+            if (records == nullptr) {
+                return;
+            }
+
+            // The queue is a stack, restore the order of the messages.
+            Record* reversed = nullptr;
+            while (records != nullptr) {
+                auto next = records->next;
+                records->next = reversed;
+                reversed = records;
+                records = next;
+            }
+
+            while (reversed != nullptr) {
+                std::unique_ptr<Record> record(reversed);
+                reversed = record->next;
+                try {
+                    write(record->severity, record->message, record->file, record->line);
+                } catch (...) {
+                    // A failing downstream must not lose the other messages.
+                }
+            }
+            flush_clog();
+        }
+
+        void write(LogSeverity severity,
+                   const std::string& message,
+                   const std::string& file,
+                   int line) {
+            if (downstream) {
+                downstream(severity, message, file, line);
+            } else {
+                std::clog << file << ": " << line << " :: " << to_string(severity) << message
+                          << '\n';
+            }
+        }
+
+        void flush_clog() {
+            if (!downstream) {
+                std::clog.flush();
+            }
+        }
+
+        Logger::callback_type downstream;
+        std::atomic<Record*> head{nullptr};
+        std::atomic<bool> stopped{false};
+        std::mutex drain_mutex;
+    };
+
+    void run() {
+        std::unique_lock<std::mutex> lock(_mutex);
+        while (!_stop) {
+            _wakeup.wait_for(lock, _interval);
+            lock.unlock();
+            flush();
+            lock.lock();
+        }
+    }
+
+    std::shared_ptr<State> _state;
+    std::chrono::milliseconds _interval;
+    std::mutex _mutex;
+    std::condition_variable _wakeup;
+    bool _stop = false;
+    std::thread _thread;
+};
+
+}  // namespace HighFive
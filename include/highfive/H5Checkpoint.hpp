@@ -0,0 +1,162 @@
+/*
+ *  Copyright (c), 2023, Blue Brain Project - EPFL
+ *
+ *  Distributed under the Boost Software License, Version 1.0.
+ *    (See accompanying file LICENSE_1_0.txt or copy at
+ *          http://www.boost.org/LICENSE_1_0.txt)
+ *
+ */
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "H5DataSet.hpp"
+#include "H5File.hpp"
+
+namespace HighFive {
+
+///
+/// \brief Rewrites only the chunks of a dataset whose content changed.
+///
+/// A checkpoint is usually rewritten in full even when only a small part of
+/// the state changed. The `DeltaCheckpointer` keeps a hash of every chunk of a
+/// chunked dataset in a companion dataset. On `write` the in-memory data is
+/// cut into tiles matching the chunks, each tile is hashed, and only the tiles
+/// whose hash differs from the stored one are written.
+///
+/// The hashes are stored with the shape of the grid of chunks, so that they
+/// remain valid when the dataset is resized along any dimension.
+///
+/// The hash is a fast non-cryptographic 64-bit hash. A changed tile with the
+/// same hash as before would not be written; for checkpoints this is an
+/// acceptable trade-off, for anything adversarial it isn't.
+///
+/// Example:
+///
+///     auto dset = file.createDataSet<double>("state", DataSpace(dims), dcpl_with_chunking);
+///     auto checkpointer = DeltaCheckpointer(file, "state");
+///     for (...) {
+///         // Update `state`, then:
+///         size_t n_written = checkpointer.write(state.data());
+///     }
+///
+class DeltaCheckpointer {
+  public:
+    ///
+    /// \brief Checkpoint the dataset `dataset_name` in `node`.
+    ///
+    /// The hashes are stored in `dataset_name + "_chunk_hashes"` next to the
+    /// dataset, which is created if needed.
+    template <typename Node>
+    DeltaCheckpointer(NodeTraits<Node>& node, const std::string& dataset_name);
+
+    ///
+    /// \brief Checkpoint `dataset`, storing the hashes in `hashes`.
+    ///
+    /// `hashes` must be a one-dimensional dataset of `uint64_t` which, if it
+    /// isn't large enough to hold one hash per chunk, must be resizable.
+    DeltaCheckpointer(const DataSet& dataset, const DataSet& hashes);
+
+    ///
+    /// \brief Write the chunks of `buffer` that changed since the last write.
+    ///
+    /// `buffer` is a contiguous, row-major array with the dimensions of the
+    /// dataset. The tiles are hashed by `n_threads` threads, the changed ones
+    /// are then written by the calling thread.
+    /// \return The number of chunks that were written.
+    template <typename T>
+    size_t write(const T* buffer, size_t n_threads = 1);
+
+    template <typename T>
+    size_t write(const std::vector<T>& buffer, size_t n_threads = 1);
+
+    /// \brief The total number of chunks of the dataset.
+    size_t getNumberChunks() const;
+
+  private:
+    void _loadLayout();
+    std::vector<uint64_t> _chunkGrid(const std::vector<size_t>& dims) const;
+    void _chunkTile(const std::vector<uint64_t>& grid,
+                    size_t i,
+                    std::vector<size_t>& offset,
+                    std::vector<size_t>& count) const;
+
+    DataSet _dataset;
+    DataSet _hashes;
+    std::vector<size_t> _dims;
+    std::vector<size_t> _chunk_dims;
+};
+
+///
+/// \brief Double-buffered checkpoint files with an atomic switch-over.
+///
+/// Writing a checkpoint over the previous one risks losing both when the
+/// writer dies half-way. A `CheckpointFile` alternates between two backing
+/// files, `<prefix>.0.h5` and `<prefix>.1.h5`. A small manifest,
+/// `<prefix>.manifest`, names the file holding the latest complete checkpoint
+/// and is replaced by an atomic rename on `commit`. Before that, the backing
+/// file and the new manifest are synced to disk; after it, the directory.
+///
+/// When the inactive file already exists, `beginCheckpoint` opens it for
+/// writing instead of truncating it. Hence, all datasets of the checkpoint
+/// before the previous one are still there, and can be overwritten instead of
+/// being created again, which saves the cost of creating the metadata:
+///
+///     auto checkpoint = CheckpointFile("state");
+///     auto file = checkpoint.beginCheckpoint();
+///     auto dset = file.exist("x") ? file.getDataSet("x")
+///                                 : file.createDataSet<double>("x", DataSpace(n));
+///     dset.write(x);
+///     checkpoint.commit(file);
+///
+/// Note that this implies that every dataset must be overwritten entirely.
+///
+/// The guarantees above hold on POSIX systems. Elsewhere, e.g. on Windows,
+/// nothing is synced to disk and the manifest is removed before it's replaced:
+/// a crash in between loses track of the checkpoints.
+///
+class CheckpointFile {
+  public:
+    explicit CheckpointFile(const std::string& prefix,
+                            const FileAccessProps& fileAccessProps = FileAccessProps::Default());
+
+    ///
+    /// \brief Open the inactive backing file for writing the next checkpoint.
+    ///
+    /// The file is created if it doesn't exist, or can't be opened, e.g.
+    /// because a previous writer died while writing to it.
+    File beginCheckpoint();
+
+    ///
+    /// \brief Flush `file` and make it the latest checkpoint.
+    ///
+    /// `file` must be the file returned by the last call to `beginCheckpoint`,
+    /// otherwise throws a `FileException`. When this returns, the checkpoint
+    /// survives a crash of the system, except on file drivers which don't
+    /// store the file under its name, e.g. the family driver.
+    void commit(File& file);
+
+    /// \brief Is there a committed checkpoint?
+    bool hasCheckpoint() const;
+
+    /// \brief The path of the file holding the latest committed checkpoint.
+    std::string getLatestPath() const;
+
+    /// \brief Open the latest committed checkpoint.
+    File openLatest(unsigned openFlags = File::ReadOnly) const;
+
+  private:
+    std::string _backingPath(int index) const;
+    std::string _manifestPath() const;
+
+    std::string _prefix;
+    FileAccessProps _fapl;
+    int _latest = -1;
+    int _pending = -1;
+};
+
+}  // namespace HighFive
+
+#include "bits/H5Checkpoint_misc.hpp"
@@ -8,8 +8,11 @@
  */
 #pragma once
 
+#include <string>
 #include <vector>
 
+#include <H5Dpublic.h>
+
 #include "H5DataSpace.hpp"
 #include "H5DataType.hpp"
 #include "H5Object.hpp"
@@ -21,6 +24,93 @@
 
 namespace HighFive {
 
+///
+/// \brief The allocated chunks of a dataset, see `DataSet::getChunkInfo`.
+///
+/// One row per chunk, stored column by column.
+///
+struct ChunkTable {
+    /// The number of dimensions of the dataset.
+    size_t n_dims = 0;
+
+    /// The offset of chunk `i`, in elements, is `offsets[i * n_dims + d]`.
+    std::vector<size_t> offsets;
+    /// The address of the chunks in the file.
+    std::vector<uint64_t> addresses;
+    /// The size of the chunks in the file, after filtering, in bytes.
+    std::vector<uint64_t> sizes;
+    /// Bit `k` is set if filter `k` of the pipeline was skipped for the chunk.
+    std::vector<unsigned> filter_masks;
+
+    /// \brief The number of chunks.
+    size_t size() const noexcept {
+        return addresses.size();
+    }
+
+    /// \brief The offset of chunk `i`.
+    std::vector<size_t> offset(size_t i) const {
+        return std::vector<size_t>(offsets.begin() + std::ptrdiff_t(i * n_dims),
+                                   offsets.begin() + std::ptrdiff_t((i + 1) * n_dims));
+    }
+};
+
+///
+/// \brief The data of an allocated chunk, see `DataSet::readSparse`.
+///
+template <typename T>
+struct SparseBlock {
+    /// The offset of the chunk in the dataset.
+    std::vector<size_t> offset;
+    /// The shape of the chunk, clipped to the dimensions of the dataset.
+    std::vector<size_t> count;
+    /// The elements of the chunk in row-major order.
+    std::vector<T> data;
+};
+
+///
+/// \brief How a dataset is stored, see `DataSet::getStorageReport`.
+///
+/// Datasets which aren't chunked count as a single chunk, which is allocated
+/// if the dataset has storage.
+///
+struct DataSetStorageReport {
+    std::string path;
+    H5D_layout_t layout = H5D_CONTIGUOUS;
+
+    /// The number of chunks covering the dataset, and the number allocated.
+    size_t n_chunks = 0;
+    size_t n_allocated_chunks = 0;
+
+    /// The size of the data of the dataset, in bytes, and of its allocated
+    /// chunks before filtering.
+    uint64_t data_size = 0;
+    uint64_t allocated_size = 0;
+
+    /// The size of the dataset in the file, in bytes.
+    uint64_t storage_size = 0;
+
+    /// The number of contiguous ranges of the file holding the chunks, and the
+    /// size of the range from the first to the end of the last chunk.
+    size_t n_extents = 0;
+    uint64_t extent_size = 0;
+
+    /// \brief The size of the allocated chunks, divided by their size in the file.
+    double compressionRatio() const noexcept {
+        return storage_size > 0 ? double(allocated_size) / double(storage_size) : 1.0;
+    }
+
+    /// \brief The fraction of the range spanned by the chunks which holds
+    /// other data: 0 if the chunks are stored back to back.
+    double fragmentation() const noexcept {
+        return extent_size > 0 ? 1.0 - double(storage_size) / double(extent_size) : 0.0;
+    }
+
+    /// \brief The fraction of the chunks which aren't allocated.
+    double unallocatedFraction() const noexcept {
+        return n_chunks > 0 ? 1.0 - double(n_allocated_chunks) / double(n_chunks) : 0.0;
+    }
+};
+
 ///
 /// \brief Class representing a dataset.
 ///
@@ -71,6 +161,114 @@ class DataSet: public Object,
     void resize(const std::vector<size_t>& dims);
 
 
+    ///
+    /// \brief Hint the OS to read ahead the chunks of a hyperslab
+    ///
+    /// This only gives a read-ahead hint, no data is read by HighFive. HDF5
+    /// reads chunks one at a time, each with a blocking `pread`. For a
+    /// selection spanning many chunks, it pays to first tell the kernel about
+    /// all of them: it then reads them concurrently and asynchronously, while
+    /// the application is still busy doing something else. A subsequent
+    /// `select(offset, count).read(...)` finds the data in the page cache.
+    ///
+    /// The hints are given with `posix_fadvise(..., POSIX_FADV_WILLNEED)` and
+    /// require a driver with a file descriptor, e.g. the default (sec2) driver
+    /// or the `IoUringDriver`. For contiguous datasets, each run of consecutive
+    /// elements is hinted, runs less than a page apart are merged. For chunked
+    /// datasets, adjacent chunks are merged into a single hint and chunks
+    /// which aren't allocated are skipped, this requires HDF5 1.10.5. On other
+    /// drivers or platforms this does nothing.
+    ///
+    /// Throws a `DataSetException` if the hyperslab isn't within the dataset.
+    /// \param offset The offset of the hyperslab
+    /// \param count The shape of the hyperslab
+    /// \return The number of bytes of the file that were hinted
+    size_t adviseWillNeed(const std::vector<size_t>& offset,
+                          const std::vector<size_t>& count) const;
+
+    /// \brief Hint the OS to read ahead the whole dataset
+    size_t adviseWillNeed() const;
+
+    ///
+    /// \brief Read the whole dataset one chunk at a time, in the order the chunks are stored
+    ///
+    /// Scanning a chunked dataset with selections which straddle chunks makes
+    /// HDF5 read, and decompress, the same chunk several times unless it stays
+    /// in the chunk cache. A full scan is fastest when every chunk is read
+    /// exactly once, in the order of the chunks in the file.
+    ///
+    /// `callback(offset, count, data)` is called once per chunk, with the
+    /// offset of the chunk, its shape clipped to the dimensions of the dataset
+    /// and a pointer to its `count[0] * ... * count[n-1]` elements in row-major
+    /// order. Chunks which were never written aren't allocated and are
+    /// skipped, they only hold the fill value. A dataset which isn't chunked is
+    /// passed as a single chunk.
+    ///
+    ///     dataset.forEachChunk<double>([&](const std::vector<size_t>& offset,
+    ///                                      const std::vector<size_t>& count,
+    ///                                      const double* data) { ... });
+    ///
+    /// With `n_threads > 1`, the chunks are still read by the calling thread,
+    /// but the callbacks run on `n_threads` worker threads, while the next
+    /// chunks are read. The callback must then be thread-safe and the chunks
+    /// are passed in no particular order. The first exception thrown by a
+    /// callback stops the scan and is rethrown.
+    ///
+    /// The chunks are read in the order they're stored. Before HDF5 1.14,
+    /// listing the chunks is quadratic in their number, see `getChunkInfo`:
+    /// from HDF5 1.10.5, datasets of up to 4096 chunks are still read in the
+    /// order they're stored, larger ones and all before 1.10.5 in the order of
+    /// their offsets. Before HDF5 1.10.2, the allocation of the chunks is
+    /// unknown: every chunk is read.
+    /// \param callback Called with the offset, the shape and the data of each chunk
+    /// \param n_threads The number of threads calling `callback`
+    /// \return The number of chunks passed to `callback`
+    template <typename T, typename F>
+    size_t forEachChunk(F&& callback, size_t n_threads = 1) const;
+
+    ///
+    /// \brief Read only the chunks which are allocated
+    ///
+    /// Reading a mostly empty dataset, e.g. a sparse grid, makes HDF5 fill the
+    /// unallocated chunks with the fill value. Instead, this returns the
+    /// offset, shape and data of the allocated chunks only, sorted by offset.
+    /// The chunks are read in the order they're stored, see `forEachChunk`.
+    template <typename T>
+    std::vector<SparseBlock<T>> readSparse() const;
+
+    ///
+    /// \brief Read the whole dataset, filling the unallocated chunks directly
+    ///
+    /// Same result as `read(array)`, but `array` is filled with the fill value
+    /// of the dataset with a single pass, a `memset` if it's zero, after which
+    /// only the allocated chunks are read into `array`. This pays off when most
+    /// chunks aren't allocated; if all are, it's a plain `read`.
+    ///
+    /// \param array A buffer for `getElementCount()` elements of a type with a
+    ///     fixed size, in row-major order
+    template <typename T>
+    void readDenseFill(T* array) const;
+
+    ///
+    /// \brief List the allocated chunks, with their address, size and filter mask
+    ///
+    /// Chunks which were never written aren't allocated and aren't listed. The
+    /// chunks are listed in the order of the chunk index of HDF5. Requires
+    /// HDF5 1.10.5 and a chunked dataset, otherwise throws a
+    /// `DataSetException`.
+    ///
+    /// With HDF5 1.14, the chunk index is traversed once. Before, HDF5 walks
+    /// the index from its start for every chunk: the cost is quadratic in the
+    /// number of chunks, seconds for tens of thousands of chunks and hours for
+    /// millions. Don't call it on hot paths with these versions.
+    ChunkTable getChunkInfo() const;
+
+    ///
+    /// \brief Summarize the allocation, compression and fragmentation of the dataset
+    ///
+    /// For chunked datasets, this lists the chunks, see `getChunkInfo` for its cost.
+    DataSetStorageReport getStorageReport() const;
+
     /// \brief Get the dimensions of the whole DataSet.
     ///       This is a shorthand for getSpace().getDimensions()
     /// \return The shape of the current HighFive::DataSet
@@ -111,6 +309,19 @@ class DataSet: public Object,
     friend class Reference;
     template <typename Derivate>
     friend class NodeTraits;
+
+#ifdef H5_HAVE_DIRECT
+  private:
+    // The alignment of buffers required by the direct I/O driver of the
+    // file, 0 for other drivers. The driver is queried once per handle.
+    size_t _getDirectIOAlignment() const;
+
+    mutable size_t _direct_io_alignment = 0;
+    mutable bool _has_direct_io_alignment = false;
+
+    template <typename>
+    friend class SliceTraits;
+#endif
 };
 
 }  // namespace HighFive
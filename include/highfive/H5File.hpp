@@ -9,7 +9,9 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
+#include "H5DataSet.hpp"
 #include "H5FileDriver.hpp"
 #include "H5Object.hpp"
 #include "H5PropertyList.hpp"
@@ -68,6 +70,53 @@ class File: public Object, public NodeTraits<File>, public AnnotateTraits<File>
          const FileCreateProps& fileCreateProps,
          const FileAccessProps& fileAccessProps = FileAccessProps::Default());
 
+    File(const File& other);
+    File(File&& other) noexcept;
+    File& operator=(const File& other);
+    File& operator=(File&& other) noexcept;
+
+    /// \brief Release this handle of the file, see `close`.
+    ~File();
+
+    ///
+    /// \brief Release this handle of the file now.
+    ///
+    /// The file is closed once all its handles and objects are released,
+    /// unless it was opened with `FileCloseDegree(H5F_CLOSE_STRONG)`: then the
+    /// file and its open datasets, groups and attributes are closed with the
+    /// last handle. The handles returned by `getFile` of these objects count
+    /// as handles of the file. Afterwards, this handle isn't valid anymore.
+    void close();
+
+    ///
+    /// \brief Create `filename` as a copy of `template_path` and open it for writing
+    ///
+    /// Creating a file with a large, fixed schema object by object, i.e.
+    /// through many calls to `createGroup`, `createDataSet` or `createAttribute`,
+    /// is dominated by the cost of creating the metadata. Copying a prebuilt
+    /// skeleton is much cheaper. Datasets of the skeleton should not have their
+    /// storage allocated, e.g. chunked datasets or `AllocationTime(H5D_ALLOC_TIME_LATE)`,
+    /// to keep the skeleton small.
+    ///
+    /// Throws a `FileException` if `filename` is the template itself.
+    /// \param template_path: filepath of the skeleton file
+    /// \param filename: filepath of the new HDF5 file, overwritten if it exists
+    /// \param fileAccessProps: the file access properties
+    static File createFromTemplate(
+        const std::string& template_path,
+        const std::string& filename,
+        const FileAccessProps& fileAccessProps = FileAccessProps::Default());
+
+    ///
+    /// \brief Create `filename` from the file image `image` and open it for writing
+    ///
+    /// Same as `createFromTemplate(const std::string&, ...)` but the skeleton
+    /// is kept in memory, see `getFileImage`.
+    static File createFromTemplate(
+        const std::vector<char>& image,
+        const std::string& filename,
+        const FileAccessProps& fileAccessProps = FileAccessProps::Default());
+
     ///
     /// \brief Return the name of the file
     ///
@@ -113,6 +162,12 @@ class File: public Object, public NodeTraits<File>, public AnnotateTraits<File>
     /// \brief Get the size of this file in bytes
     size_t getFileSize() const;
 
+    /// \brief Get a copy of the content of this file
+    ///
+    /// This is a wrapper of `H5Fget_file_image`. The image can be used to
+    /// create new files with `createFromTemplate`.
+    std::vector<char> getFileImage() const;
+
     /// \brief Get the amount of tracked, unused space in bytes.
     ///
     /// Note, this is a wrapper for `H5Fget_freespace` and returns the number
@@ -121,13 +176,47 @@ class File: public Object, public NodeTraits<File>, public AnnotateTraits<File>
     /// might not track everything or not track across open-close cycles.
     size_t getFreeSpace() const;
 
+    /// \brief List the datasets, groups, committed datatypes and attributes
+    /// of this file which are open.
+    ///
+    /// Every open object keeps its file open, unless the file was opened with
+    /// `FileCloseDegree(H5F_CLOSE_STRONG)`. Objects opened through other `File`
+    /// handles of the same file are listed too.
+    std::vector<OpenObject> getOpenObjects() const;
+
+    /// \brief Report how every dataset of the file is stored.
+    ///
+    /// Visits the file once and returns the `DataSet::getStorageReport` of
+    /// every dataset, e.g. to find the datasets which compress poorly, are
+    /// mostly unallocated or fragmented. A dataset reached by several hard
+    /// links is reported once, under the first of its paths.
+    std::vector<DataSetStorageReport> storageReport() const;
+
+    /// \brief Warn about the objects still open when a file is closed.
+    ///
+    /// When enabled, destroying the last `File` handle of a file logs a warning
+    /// listing the objects which are still open, see `getOpenObjects`. It's
+    /// meant for finding leaked copies of `DataSet`, `Group`, etc. which keep
+    /// the file open. The check is process-wide and enabled by default if
+    /// `HIGHFIVE_CHECK_OPEN_OBJECTS` is defined.
+    static void setOpenObjectsCheck(bool enabled) noexcept;
+
+    /// \brief Is the check of `setOpenObjectsCheck` enabled?
+    static bool hasOpenObjectsCheck() noexcept;
+
   protected:
     File() = default;
     using Object::Object;
 
   private:
+    void _release() noexcept;
+
     mutable std::string _filename{};
 
+    // Set for the handles returned by `getFile` of datasets, groups and
+    // attributes, and their copies, as opposed to those the application opened.
+    bool _held_by_object = false;
+
     template <typename>
     friend class PathTraits;
 };
@@ -0,0 +1,172 @@
+/*
+ *  Copyright (c), 2023, Blue Brain Project - EPFL
+ *
+ *  Distributed under the Boost Software License, Version 1.0.
+ *    (See accompanying file LICENSE_1_0.txt or copy at
+ *          http://www.boost.org/LICENSE_1_0.txt)
+ *
+ */
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <H5Ipublic.h>
+
+#include "H5Exception.hpp"
+
+namespace HighFive {
+
+///
+/// \brief Records every read and write of a dataset to a compact binary log.
+///
+/// When a job is slow because of its I/O, the pattern of accesses is what
+/// matters, not the data. While tracing is active, every `read`, `read_raw`,
+/// `write` and `write_raw` of a `DataSet` or `Selection` which succeeds
+/// appends an event to the trace: the file and the path of the dataset, the
+/// type and bounding box of the selection, the number of elements, when it
+/// started and how long it took. Accesses which fail aren't recorded. The
+/// trace can be replayed offline against a synthetic file with
+/// `highfive_replay`, see `src/benchmarks`, to compare drivers, chunk caches
+/// and layouts.
+///
+/// Only the bounding box of a selection is stored, not its shape: replaying a
+/// strided hyperslab or a set of points accesses its whole bounding box.
+/// `Event::selection` tells which accesses are affected.
+///
+///     IOTrace::start("job.trace");
+///     // ... run the job ...
+///     IOTrace::stop();
+///
+/// When tracing isn't active, the overhead is that of reading an atomic flag.
+/// Tracing is process-wide and thread-safe. The names of the file and of the
+/// dataset are looked up once per dataset id, renaming a dataset while it's
+/// open and traced isn't reflected in the trace.
+///
+/// The trace is written in native byte order. It starts with the eight
+/// bytes `HFIOTRC2`, followed by records which each start with one byte:
+///  - `D`: defines a dataset: `uint32` id, `uint32` length of the name of the
+///    file, the name of the file, `uint32` length of the path, the path,
+///    `uint32` element size, `uint32` rank, `uint64` dimensions.
+///  - `R` or `W`: a read or write: `uint32` id of the dataset, `uint64` start
+///    and duration in nanoseconds, `uint64` number of elements, `char` type
+///    of the selection, `uint32` rank, `uint64` offset and `uint64` count of
+///    the bounding box of the selection.
+///
+class IOTrace {
+  public:
+    enum class Operation : char { Read = 'R', Write = 'W' };
+
+    /// \brief The type of a selection.
+    enum class SelectionType : char {
+        /// Nothing is selected.
+        None = 'N',
+        /// The whole dataset.
+        All = 'A',
+        /// A hyperslab which covers its bounding box, e.g. a single block.
+        Box = 'B',
+        /// Any other hyperslab, e.g. strided or the union of several blocks.
+        Hyperslab = 'H',
+        /// A set of points.
+        Points = 'P'
+    };
+
+    /// \brief An access to a dataset, as stored in the trace.
+    struct Event {
+        Operation operation;
+        /// The name of the file, as passed to `H5Fopen`.
+        std::string file;
+        /// The path of the dataset in `file`.
+        std::string dataset;
+        std::vector<size_t> dataset_dims;
+        size_t element_size;
+        /// Nanoseconds since the trace was started.
+        uint64_t start;
+        /// Nanoseconds the access took.
+        uint64_t duration;
+        /// The number of selected elements.
+        size_t n_elements;
+        /// The type of the selection, only `All` and `Box` cover their bounding box.
+        SelectionType selection;
+        /// The bounding box of the selection.
+        std::vector<size_t> offset;
+        std::vector<size_t> count;
+    };
+
+    /// \brief Start tracing to `filename`, overwriting it.
+    ///
+    /// If tracing is active, the current trace is stopped first.
+    static void start(const std::string& filename);
+
+    /// \brief Stop tracing and close the trace.
+    static void stop();
+
+    /// \brief Is tracing active?
+    static bool isActive() noexcept;
+
+    /// \brief Load all events of the trace `filename`.
+    static std::vector<Event> load(const std::string& filename);
+
+    /// \brief Append an event for the access to `dataset_id` selected by `file_space_id`.
+    ///
+    /// Called by `SliceTraits` once the access succeeded, there's usually no
+    /// need to call this directly.
+    static void record(Operation operation,
+                       hid_t dataset_id,
+                       hid_t file_space_id,
+                       std::chrono::steady_clock::time_point start,
+                       std::chrono::steady_clock::time_point stop) noexcept;
+};
+
+namespace details {
+
+///
+/// \brief Times an access and records it, if tracing is active, once `succeeded` is called.
+///
+/// An access which throws before `succeeded` isn't recorded.
+///
+class IOTraceScope {
+  public:
+    IOTraceScope(IOTrace::Operation operation, hid_t dataset_id, hid_t file_space_id) noexcept
+        : _active(IOTrace::isActive())
+        , _operation(operation)
+        , _dataset_id(dataset_id)
+        , _file_space_id(file_space_id) {
+        if (_active) {
+            _start = std::chrono::steady_clock::now();
+        }
+    }
+
+    IOTraceScope(const IOTraceScope&) = delete;
+    IOTraceScope& operator=(const IOTraceScope&) = delete;
+
+    void succeeded() noexcept {
+        if (_active) {
+            IOTrace::record(_operation,
+                            _dataset_id,
+                            _file_space_id,
+                            _start,
+                            std::chrono::steady_clock::now());
+        }
+    }
+
+  private:
+    bool _active;
+    IOTrace::Operation _operation;
+    hid_t _dataset_id;
+    hid_t _file_space_id;
+    std::chrono::steady_clock::time_point _start;
+};
+
+}  // namespace details
+
+}  // namespace HighFive
+
+#include "bits/H5IOTrace_misc.hpp"
@@ -0,0 +1,72 @@
+/*
+ *  Copyright (c), 2023, Blue Brain Project - EPFL
+ *
+ *  Distributed under the Boost Software License, Version 1.0.
+ *    (See accompanying file LICENSE_1_0.txt or copy at
+ *          http://www.boost.org/LICENSE_1_0.txt)
+ *
+ */
+#pragma once
+
+#if defined(__linux__)
+
+#include <cstddef>
+
+#include <H5FDpublic.h>
+
+#include "H5PropertyList.hpp"
+
+namespace HighFive {
+
+///
+/// \brief A file driver which reads and writes with Linux io_uring.
+///
+/// The default sec2 driver reads and writes with one blocking `pread` or
+/// `pwrite` at a time. This driver splits large requests, e.g. of contiguous
+/// datasets or of large chunks, into pieces of `block_size` bytes which are
+/// submitted together to an io_uring queue of `queue_depth` entries, so that
+/// the device works on all of them at once. With HDF5 1.14, the lists of
+/// requests HDF5 issues for selection I/O, e.g. for the chunks of a selection,
+/// are submitted together as well. Requests of at most `block_size` bytes,
+/// e.g. of metadata, are passed to `pread` and `pwrite` directly.
+///
+/// io_uring is used through its system calls, it requires Linux 5.1 but
+/// neither liburing nor special hardware. Where it's unavailable, e.g. if it
+/// is disabled with the sysctl `kernel.io_uring_disabled` or by a seccomp
+/// filter, the driver reads and writes with `pread` and `pwrite`, see
+/// `isAvailable`.
+///
+/// Otherwise, the driver behaves like sec2: files can be opened for writing,
+/// and `DataSet::adviseWillNeed` gives read-ahead hints to the kernel.
+///
+///     FileAccessProps fapl;
+///     fapl.add(IoUringDriver());
+///     File file("data.h5", File::ReadOnly, fapl);
+///
+class IoUringDriver {
+  public:
+    ///
+    /// \param queue_depth The number of requests submitted at once
+    /// \param block_size The size in bytes of the pieces of large requests
+    explicit IoUringDriver(unsigned queue_depth = 32, size_t block_size = 1024 * 1024);
+    explicit IoUringDriver(const FileAccessProps& fapl);
+
+    unsigned getQueueDepth() const noexcept;
+    size_t getBlockSize() const noexcept;
+
+    /// \brief Can this process use io_uring? Otherwise, the driver uses `pread` and `pwrite`.
+    static bool isAvailable();
+
+  private:
+    friend FileAccessProps;
+    void apply(const hid_t list) const;
+
+    unsigned _queue_depth;
+    size_t _block_size;
+};
+
+}  // namespace HighFive
+
+#include "bits/H5IoUringDriver_misc.hpp"
+
+#endif
@@ -0,0 +1,100 @@
+/*
+ *  Copyright (c), 2023, Blue Brain Project - EPFL
+ *
+ *  Distributed under the Boost Software License, Version 1.0.
+ *    (See accompanying file LICENSE_1_0.txt or copy at
+ *          http://www.boost.org/LICENSE_1_0.txt)
+ *
+ */
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "H5File.hpp"
+
+namespace HighFive {
+
+///
+/// \brief The memory held by HDF5 and HighFive, see `memoryReport`.
+///
+struct MemoryReport {
+    ///
+    /// \brief The memory held for an open file.
+    ///
+    struct FileMemory {
+        std::string name;
+
+        /// The maximum and current size of the metadata cache, in bytes, and
+        /// its number of entries, see `H5Fget_mdc_size`.
+        size_t metadata_cache_max_size = 0;
+        size_t metadata_cache_size = 0;
+        size_t metadata_cache_entries = 0;
+
+        /// The default chunk cache of the datasets of the file, see
+        /// `H5Pget_cache`. Every open chunked dataset may hold up to
+        /// `chunk_cache_size` bytes.
+        size_t chunk_cache_slots = 0;
+        size_t chunk_cache_size = 0;
+
+        /// The objects of the file which are open, see `H5Fget_obj_count`.
+        size_t open_datasets = 0;
+        size_t open_groups = 0;
+        size_t open_datatypes = 0;
+        size_t open_attributes = 0;
+    };
+
+    /// The bytes held by the free lists of HDF5, see `H5get_free_list_sizes`.
+    /// They're zero before HDF5 1.10.7.
+    size_t free_list_regular_size = 0;
+    size_t free_list_array_size = 0;
+    size_t free_list_block_size = 0;
+    size_t free_list_factory_size = 0;
+
+    /// One entry per open file identifier.
+    std::vector<FileMemory> files;
+
+    /// The bytes held by HighFive to convert data to and from the layout
+    /// passed to HDF5, e.g. to read a `std::vector<std::vector<double>>`,
+    /// and the largest number of bytes they held at once. Counting them costs
+    /// atomic operations on every conversion, hence they're zero unless
+    /// `HIGHFIVE_TRACK_STAGING_MEMORY` is defined before including HighFive.
+    size_t staging_size = 0;
+    size_t staging_peak_size = 0;
+};
+
+///
+/// \brief Report the memory held by HDF5 for its free lists and open files,
+/// and by HighFive for its staging buffers.
+///
+/// Meant to attribute the memory of long-running processes, e.g. by logging
+/// it periodically.
+///
+MemoryReport memoryReport();
+
+///
+/// \brief Limits on the free lists of HDF5, in bytes; -1 means no limit.
+///
+/// The free lists keep released memory for reuse, which can grow large,
+/// e.g. after many small reads. See `H5set_free_list_limits`.
+///
+struct FreeListLimits {
+    int regular_global = -1;
+    int regular_list = -1;
+    int array_global = -1;
+    int array_list = -1;
+    int block_global = -1;
+    int block_list = -1;
+};
+
+///
+/// \brief Set the limits of the free lists of HDF5, for the whole process.
+///
+/// The limits apply to memory released from now on; free lists larger than
+/// their limit are garbage collected.
+///
+void setFreeListLimits(const FreeListLimits& limits);
+
+}  // namespace HighFive
+
+#include "bits/H5Memory_misc.hpp"
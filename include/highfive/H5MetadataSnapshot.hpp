@@ -0,0 +1,66 @@
+/*
+ *  Copyright (c), 2023, Blue Brain Project - EPFL
+ *
+ *  Distributed under the Boost Software License, Version 1.0.
+ *    (See accompanying file LICENSE_1_0.txt or copy at
+ *          http://www.boost.org/LICENSE_1_0.txt)
+ *
+ */
+#pragma once
+
+// Defines H5_HAVE_PARALLEL
+#include <H5public.h>
+
+#ifdef H5_HAVE_PARALLEL
+
+#include <string>
+
+#include <mpi.h>
+
+#include "H5File.hpp"
+#include "H5PropertyList.hpp"
+
+namespace HighFive {
+
+///
+/// \brief Read the metadata of a file on one rank and broadcast it to all ranks.
+///
+/// When thousands of ranks open a file and traverse its groups and attributes
+/// independently, every rank queries the metadata server of the parallel file
+/// system. Instead, the rank `root` traverses the file and copies its
+/// structure, i.e. groups, links, committed datatypes, datasets without their
+/// data and all attributes, into an in-memory file. The image of this file is
+/// broadcast and every rank opens it as a read-only `File`, which answers
+/// `listObjectNames`, `getAttribute(...).read`, `getDimensions`, `getDataType`,
+/// etc. without touching the file system.
+///
+/// Datasets of the snapshot have no storage: reading them returns their fill
+/// value. Object references in attributes refer to the original file and are
+/// meaningless in the snapshot.
+///
+/// This is a collective operation on `comm`.
+///
+/// \param file The file, open on all ranks of `comm`, e.g. with `MPIOFileAccess`.
+///     Only `root` reads from it. The traversal disables collective metadata
+///     reads, hence it is fine for `file` to use `MPIOCollectiveMetadataRead`.
+/// \param comm The communicator
+/// \param root The rank which reads the metadata
+/// \return The snapshot, an in-memory file opened read-only
+File createMetadataSnapshot(const File& file, MPI_Comm comm, int root = 0);
+
+///
+/// \brief Read the metadata of the file `filename` on one rank and broadcast it to all ranks.
+///
+/// Same as `createMetadataSnapshot(const File&, ...)`, except that only
+/// `root` opens the file, read-only and with the file access properties
+/// `fapl`; the other ranks never access it.
+File createMetadataSnapshot(const std::string& filename,
+                            MPI_Comm comm,
+                            int root = 0,
+                            const FileAccessProps& fapl = FileAccessProps::Default());
+
+}  // namespace HighFive
+
+#include "bits/H5MetadataSnapshot_misc.hpp"
+
+#endif
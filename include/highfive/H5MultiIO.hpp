@@ -0,0 +1,89 @@
+/*
+ *  Copyright (c), 2023, Blue Brain Project - EPFL
+ *
+ *  Distributed under the Boost Software License, Version 1.0.
+ *    (See accompanying file LICENSE_1_0.txt or copy at
+ *          http://www.boost.org/LICENSE_1_0.txt)
+ *
+ */
+#pragma once
+
+#include <vector>
+
+#include "H5DataSet.hpp"
+#include "H5DataSpace.hpp"
+#include "H5DataType.hpp"
+#include "H5File.hpp"
+#include "H5PropertyList.hpp"
+
+namespace HighFive {
+
+///
+/// \brief Reads or writes several datasets, or selections thereof, in one call.
+///
+/// HDF5 1.14 added `H5Dread_multi` and `H5Dwrite_multi`, which process the
+/// accesses to many datasets at once. With MPI-IO and collective transfers,
+/// this turns one collective operation per dataset into a single one. With
+/// older versions of HDF5, the datasets are accessed one after the other.
+///
+/// The buffers are passed as pointers, analogous to `read_raw` and
+/// `write_raw`, i.e. they must be contiguous and hold as many elements as
+/// the respective selection.
+///
+///     MultiIO io;
+///     io.add(file.getDataSet("x"), x.data());
+///     io.add(file.getDataSet("y").select({offset}, {count}), y.data());
+///     io.read(xfer_props);
+///
+class MultiIO {
+  public:
+    ///
+    /// \brief Add the dataset or selection `slice`, with the buffer `buffer`.
+    ///
+    /// The memory datatype is deduced from `T`.
+    template <typename Derivate, typename T>
+    void add(const SliceTraits<Derivate>& slice, T* buffer);
+
+    ///
+    /// \brief Add the dataset or selection `slice`, with the read-only buffer `buffer`.
+    ///
+    /// A batch containing read-only buffers can only be written.
+    template <typename Derivate, typename T>
+    void add(const SliceTraits<Derivate>& slice, const T* buffer);
+
+    ///
+    /// \brief Add `slice` with the buffer `buffer` of the memory datatype `mem_datatype`.
+    template <typename Derivate>
+    void add(const SliceTraits<Derivate>& slice, void* buffer, const DataType& mem_datatype);
+
+    /// \brief Read all datasets of the batch into their buffers.
+    void read(const DataTransferProps& xfer_props = DataTransferProps()) const;
+
+    /// \brief Write all buffers of the batch to their datasets.
+    void write(const DataTransferProps& xfer_props = DataTransferProps()) const;
+
+    /// \brief The number of datasets in the batch.
+    size_t size() const noexcept;
+
+    /// \brief Remove all datasets from the batch.
+    void clear() noexcept;
+
+  private:
+    template <typename Derivate>
+    void _add(const SliceTraits<Derivate>& slice,
+              const DataType& mem_datatype,
+              void* buffer,
+              bool read_only);
+
+    // Keep the HDF5 objects alive for as long as their ids are used.
+    std::vector<DataSet> _datasets;
+    std::vector<DataType> _mem_types;
+    std::vector<DataSpace> _mem_spaces;
+    std::vector<DataSpace> _file_spaces;
+    std::vector<void*> _buffers;
+    bool _read_only = false;
+};
+
+}  // namespace HighFive
+
+#include "bits/H5MultiIO_misc.hpp"
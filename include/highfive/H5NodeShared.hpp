@@ -0,0 +1,103 @@
+/*
+ *  Copyright (c), 2023, Blue Brain Project - EPFL
+ *
+ *  Distributed under the Boost Software License, Version 1.0.
+ *    (See accompanying file LICENSE_1_0.txt or copy at
+ *          http://www.boost.org/LICENSE_1_0.txt)
+ *
+ */
+#pragma once
+
+// Defines H5_HAVE_PARALLEL
+#include <H5public.h>
+
+#ifdef H5_HAVE_PARALLEL
+
+#include <vector>
+
+#include <mpi.h>
+
+#include "H5DataSet.hpp"
+#include "H5File.hpp"
+#include "H5PropertyList.hpp"
+
+namespace HighFive {
+
+///
+/// \brief A read-only copy of a dataset shared by all MPI ranks of a node.
+///
+/// When every rank of a node reads the same large dataset, e.g. a lookup
+/// table, the file system serves the same data once per rank and every rank
+/// keeps its own copy in memory. Instead, one rank per node reads the dataset
+/// into an MPI-3 shared memory window. All other ranks on the node access
+/// the data directly in the window, without copying it.
+///
+///     auto table = NodeSharedDataSet<double>(file.getDataSet("table"), MPI_COMM_WORLD);
+///     double x = table[42];
+///
+/// The constructor and the destructor are collective over `comm`. The
+/// dataset must be open on all ranks of `comm`. Only the first rank of each
+/// node reads it, hence `xfer_props` must not request collective I/O.
+///
+template <typename T>
+class NodeSharedDataSet {
+  public:
+    NodeSharedDataSet(const DataSet& dataset,
+                      MPI_Comm comm,
+                      const DataTransferProps& xfer_props = DataTransferProps());
+
+    NodeSharedDataSet(const NodeSharedDataSet&) = delete;
+    NodeSharedDataSet& operator=(const NodeSharedDataSet&) = delete;
+
+    NodeSharedDataSet(NodeSharedDataSet&& other) noexcept;
+    NodeSharedDataSet& operator=(NodeSharedDataSet&& other) noexcept;
+
+    ~NodeSharedDataSet();
+
+    /// \brief The data of the dataset, in row-major order.
+    const T* data() const noexcept {
+        return _data;
+    }
+
+    /// \brief The number of elements of the dataset.
+    size_t size() const noexcept {
+        return _size;
+    }
+
+    const T& operator[](size_t i) const noexcept {
+        return _data[i];
+    }
+
+    const T* begin() const noexcept {
+        return _data;
+    }
+
+    const T* end() const noexcept {
+        return _data + _size;
+    }
+
+    /// \brief The dimensions of the dataset.
+    const std::vector<size_t>& getDimensions() const noexcept {
+        return _dims;
+    }
+
+    /// \brief The communicator of the ranks sharing the memory.
+    MPI_Comm getNodeComm() const noexcept {
+        return _node_comm;
+    }
+
+  private:
+    void _free() noexcept;
+
+    MPI_Comm _node_comm = MPI_COMM_NULL;
+    MPI_Win _window = MPI_WIN_NULL;
+    const T* _data = nullptr;
+    size_t _size = 0;
+    std::vector<size_t> _dims;
+};
+
+}  // namespace HighFive
+
+#include "bits/H5NodeShared_misc.hpp"
+
+#endif
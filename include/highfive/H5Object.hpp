@@ -9,6 +9,7 @@
 #pragma once
 
 #include <ctime>
+#include <string>
 
 #include <H5Ipublic.h>
 #include <H5Opublic.h>
@@ -150,6 +151,16 @@ class ObjectInfo {
     friend class Object;
 };
 
+///
+/// \brief An open object of a file, see `File::getOpenObjects`.
+///
+struct OpenObject {
+    ObjectType type;
+    /// The path of the object, for attributes the path of the object they're
+    /// attached to. Empty if the object has no name, e.g. it was unlinked.
+    std::string path;
+};
+
 }  // namespace HighFive
 
 #include "bits/H5Object_misc.hpp"
@@ -0,0 +1,67 @@
+/*
+ *  Copyright (c), 2023, Blue Brain Project - EPFL
+ *
+ *  Distributed under the Boost Software License, Version 1.0.
+ *    (See accompanying file LICENSE_1_0.txt or copy at
+ *          http://www.boost.org/LICENSE_1_0.txt)
+ *
+ */
+#pragma once
+
+// Defines H5_HAVE_PARALLEL
+#include <H5public.h>
+
+#ifdef H5_HAVE_PARALLEL
+
+#include <vector>
+
+#include <mpi.h>
+
+#include "H5DataSet.hpp"
+#include "H5File.hpp"
+#include "H5PropertyList.hpp"
+
+namespace HighFive {
+
+///
+/// \brief Read an arbitrary block per MPI rank, e.g. after a change of decomposition.
+///
+/// Restarting with a different number of ranks means that every rank needs
+/// a block of the dataset which is unrelated to how it was written. Reading
+/// these blocks directly results in many small, unaligned and
+/// non-contiguous reads. Instead, the bounding box of all blocks is cut into
+/// slabs along the first dimension. The slabs are aligned with the chunks of
+/// the dataset and every rank reads one of them, using `xfer_props`, e.g.
+/// with `UseCollectiveIO`. The data is then sent to the ranks which need it
+/// with a single `MPI_Alltoallv`.
+///
+/// Only the first dimension is cut: every slab spans the bounding box in all
+/// other dimensions, and the whole bounding box is read, including the
+/// parts which no rank needs. This pays off when the blocks of the ranks
+/// cover most of their bounding box, e.g. a new decomposition of the whole
+/// dataset. For a few small blocks far apart, reading each block directly
+/// reads much less.
+///
+/// This is a collective operation on `comm`. The dataset must be open on all
+/// ranks of `comm`, and every rank passes the block it needs. Blocks may
+/// overlap and may be empty. If the block of a rank isn't within the dataset,
+/// or reading a slab fails on a rank, all ranks throw.
+///
+/// \param dataset The dataset to read from
+/// \param offset The offset of the block needed by this rank
+/// \param count The shape of the block needed by this rank
+/// \param comm The communicator
+/// \param xfer_props The data transfer properties used for reading the slabs
+/// \return The block needed by this rank, in row-major order
+template <typename T>
+std::vector<T> readRedistributed(const DataSet& dataset,
+                                 const std::vector<size_t>& offset,
+                                 const std::vector<size_t>& count,
+                                 MPI_Comm comm,
+                                 const DataTransferProps& xfer_props = DataTransferProps());
+
+}  // namespace HighFive
+
+#include "bits/H5ParallelRead_misc.hpp"
+
+#endif
@@ -8,15 +8,26 @@
  */
 #pragma once
 
+#include <map>
+#include <string>
 #include <vector>
 
 #include <H5Ppublic.h>
 
+// Required by SplitDriver, MultiDriver and FamilyDriver
+#include <H5FDfamily.h>
+#include <H5FDmulti.h>
+
 // Required by MPIOFileAccess
 #ifdef H5_HAVE_PARALLEL
 #include <H5FDmpi.h>
 #endif
 
+// Required by DirectIO
+#ifdef H5_HAVE_DIRECT
+#include <H5FDdirect.h>
+#endif
+
 #include "H5Exception.hpp"
 #include "H5Object.hpp"
 
@@ -337,6 +348,171 @@ class MetadataBlockSize {
     hsize_t _size;
 };
 
+///
+/// \brief Configure what happens to the open objects of a file when it's closed.
+///
+/// A `File` is closed when its last copy is destroyed. However, every
+/// `DataSet`, `Group`, `Attribute` or `DataType` of the file which is still
+/// alive keeps the file open by default, i.e. with `H5F_CLOSE_WEAK`, and with
+/// it the metadata cache and chunk caches. Possible values are:
+/// * \c H5F_CLOSE_WEAK the file stays open until all its objects are closed;
+/// * \c H5F_CLOSE_SEMI closing the file fails if any object is open;
+/// * \c H5F_CLOSE_STRONG the open objects are closed with the file, any use
+///   of them afterwards fails;
+/// * \c H5F_CLOSE_DEFAULT the default of the driver, i.e. weak.
+///
+/// Strong close releases the memory of a file predictably when its `File`
+/// goes out of scope. See also `File::getOpenObjects` to find which objects
+/// keep a file open.
+///
+class FileCloseDegree {
+  public:
+    explicit FileCloseDegree(H5F_close_degree_t degree);
+    explicit FileCloseDegree(const FileAccessProps& fapl);
+
+    H5F_close_degree_t getDegree() const;
+
+  private:
+    friend FileAccessProps;
+    void apply(const hid_t list) const;
+    H5F_close_degree_t _degree;
+};
+
+///
+/// \brief Store metadata and raw data in two separate files.
+///
+/// Traversing a file, e.g. listing groups or reading attributes, only needs
+/// the metadata. When the metadata is stored in a small file on fast storage,
+/// e.g. an SSD, while the raw data is on bulk storage, these operations are no
+/// longer limited by the latency of the bulk storage.
+///
+/// The name of the metadata file is the name of the file followed by
+/// `meta_ext`, analogous for the raw data. If the extension contains `%s`, it
+/// is used as a `printf` format instead, with the file name as argument.
+/// Hence, a symbolic link to a directory on another file system is one way of
+/// moving the metadata file elsewhere.
+///
+/// Please also consult the upstream documentation of `H5Pset_fapl_split`.
+///
+class SplitDriver {
+  public:
+    ///
+    /// \param meta_ext The extension of the file containing the metadata.
+    /// \param raw_ext The extension of the file containing the raw data.
+    /// \param meta_fapl The file access properties of the metadata file.
+    /// \param raw_fapl The file access properties of the raw data file.
+    explicit SplitDriver(const std::string& meta_ext = "-m.h5",
+                         const std::string& raw_ext = "-r.h5",
+                         const FileAccessProps& meta_fapl = FileAccessProps::Default(),
+                         const FileAccessProps& raw_fapl = FileAccessProps::Default());
+
+  private:
+    friend FileAccessProps;
+    void apply(const hid_t list) const;
+
+    std::string _meta_ext;
+    std::string _raw_ext;
+    FileAccessProps _meta_fapl;
+    FileAccessProps _raw_fapl;
+};
+
+///
+/// \brief Store the different kinds of data in separate files.
+///
+/// A generalization of the `SplitDriver`. Every type of data, see
+/// `H5FD_mem_t`, which is listed in `members` is stored in its own file. The
+/// name of the file is given as a `printf` format with the file name as
+/// argument, e.g. `"%s-btree.h5"`. All types which aren't listed are stored
+/// with the superblock, `H5FD_MEM_SUPER`, which defaults to `"%s-s.h5"`.
+///
+/// Please also consult the upstream documentation of `H5Pset_fapl_multi`.
+///
+class MultiDriver {
+  public:
+    ///
+    /// \param members The name format of the file for each type of data.
+    /// \param relax Allow opening the file even if some members are missing.
+    explicit MultiDriver(const std::map<H5FD_mem_t, std::string>& members,
+                         bool relax = false);
+
+  private:
+    friend FileAccessProps;
+    void apply(const hid_t list) const;
+
+    std::map<H5FD_mem_t, std::string> _members;
+    bool _relax;
+};
+
+///
+/// \brief Split a file into a family of member files of a fixed size.
+///
+/// Useful on file systems which limit the size of files, or which perform
+/// better with many moderately sized files. The name of the file must contain
+/// a `printf`-style integer pattern, e.g. `"data-%05d.h5"`, which is replaced
+/// by the index of the member file. Every member but the last one is exactly
+/// `member_size` bytes large.
+///
+/// Please also consult the upstream documentation of `H5Pset_fapl_family`.
+///
+class FamilyDriver {
+  public:
+    ///
+    /// \param member_size The size of each member file in bytes.
+    /// \param member_fapl The file access properties of the member files.
+    explicit FamilyDriver(hsize_t member_size,
+                          const FileAccessProps& member_fapl = FileAccessProps::Default());
+    explicit FamilyDriver(const FileAccessProps& fapl);
+
+    hsize_t getMemberSize() const;
+
+  private:
+    friend FileAccessProps;
+    void apply(const hid_t list) const;
+
+    hsize_t _member_size;
+    FileAccessProps _member_fapl;
+};
+
+#ifdef H5_HAVE_DIRECT
+///
+/// \brief Use the direct I/O driver, i.e. bypass the page cache with `O_DIRECT`.
+///
+/// Useful for streaming very large amounts of data which won't be read again
+/// soon, since it neither fills the page cache nor causes writeback stalls.
+///
+/// The direct I/O driver requires that buffers in memory are aligned to
+/// `alignment`. Other buffers are copied through a bounce buffer of at most
+/// `cbuf_size` bytes, which is slow. Use `AlignedAllocator` to obtain aligned
+/// buffers.
+///
+/// Please also consult the upstream documentation of `H5Pset_fapl_direct`.
+/// This is only available if HDF5 was built with the direct driver.
+///
+class DirectIO {
+  public:
+    ///
+    /// \param alignment Required alignment of memory buffers in bytes.
+    /// \param block_size The block size of the file system in bytes.
+    /// \param cbuf_size Size of the bounce buffer for unaligned buffers in bytes.
+    explicit DirectIO(size_t alignment = MBOUNDARY_DEF,
+                      size_t block_size = FBSIZE_DEF,
+                      size_t cbuf_size = CBSIZE_DEF);
+    explicit DirectIO(const FileAccessProps& fapl);
+
+    size_t getAlignment() const;
+    size_t getBlockSize() const;
+    size_t getCopyBufferSize() const;
+
+  private:
+    friend FileAccessProps;
+    void apply(const hid_t list) const;
+
+    size_t _alignment;
+    size_t _block_size;
+    size_t _cbuf_size;
+};
+#endif
+
 #if H5_VERSION_GE(1, 10, 1)
 ///
 /// \brief Configure the file space strategy.
@@ -695,6 +871,61 @@ class AttributePhaseChange {
     unsigned _min_dense;
 };
 
+///
+/// \brief Set threshold for link storage.
+///
+/// HDF5 can store the links of a group in the object header (compact) or in
+/// a B-tree (dense). This property sets the threshold when links are moved to
+/// one or the other storage format. It requires the file format of HDF5 1.8,
+/// see `FileVersionBounds`.
+///
+/// Please refer to the upstream documentation of `H5Pset_link_phase_change`.
+///
+class LinkPhaseChange {
+  public:
+    ///
+    /// \brief Create the property from the threshold values.
+    ///
+    /// When the number of links hits `max_compact` the links are moved to
+    /// dense storage, once the number drops to below `min_dense` the links
+    /// are moved to compact storage.
+    LinkPhaseChange(unsigned max_compact, unsigned min_dense);
+
+    /// \brief Extract threshold values from property list.
+    explicit LinkPhaseChange(const GroupCreateProps& gcpl);
+
+    unsigned max_compact() const;
+    unsigned min_dense() const;
+
+  private:
+    friend GroupCreateProps;
+    void apply(hid_t hid) const;
+
+    unsigned _max_compact;
+    unsigned _min_dense;
+};
+
+///
+/// \brief Configure how objects are copied with `H5Ocopy`.
+///
+/// The flags are a combination of the upstream `H5O_COPY_*` flags, e.g.
+/// `H5O_COPY_SHALLOW_HIERARCHY_FLAG` or `H5O_COPY_WITHOUT_ATTR_FLAG`. Please
+/// refer to the upstream documentation of `H5Pset_copy_object`.
+///
+class CopyObjectFlags {
+  public:
+    explicit CopyObjectFlags(unsigned flags);
+    explicit CopyObjectFlags(const ObjectCopyProps& ocpypl);
+
+    unsigned getFlags() const;
+
+  private:
+    friend ObjectCopyProps;
+    void apply(hid_t hid) const;
+
+    unsigned _flags;
+};
+
 /// @}
 
 }  // namespace HighFive
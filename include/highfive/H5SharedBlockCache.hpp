@@ -0,0 +1,110 @@
+/*
+ *  Copyright (c), 2023, Blue Brain Project - EPFL
+ *
+ *  Distributed under the Boost Software License, Version 1.0.
+ *    (See accompanying file LICENSE_1_0.txt or copy at
+ *          http://www.boost.org/LICENSE_1_0.txt)
+ *
+ */
+#pragma once
+
+#if defined(__unix__)
+
+#include <cstdint>
+#include <string>
+
+#include <H5FDpublic.h>
+
+#include "H5PropertyList.hpp"
+
+namespace HighFive {
+
+///
+/// \brief The counters of a `SharedBlockCache`, summed over all processes using it.
+///
+struct BlockCacheStats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t evictions = 0;
+
+    /// The number of blocks in the cache, and the maximum.
+    size_t n_blocks = 0;
+    size_t max_blocks = 0;
+
+    /// The size of a block in bytes.
+    size_t block_size = 0;
+
+    /// \brief The fraction of the lookups that were hits, 0 if there were none.
+    double getHitRate() const noexcept {
+        return hits + misses == 0 ? 0.0 : double(hits) / double(hits + misses);
+    }
+};
+
+///
+/// \brief A file driver which caches the blocks of read-only files in shared memory.
+///
+/// Every process opening a file has its own metadata and chunk caches, hence
+/// many processes of a node reading the same files read the same data over
+/// and over. This driver reads files with `pread`, like the default sec2
+/// driver, through an LRU cache of blocks in the POSIX shared memory segment
+/// `name`, see `shm_open`. All processes using the same `name` share the
+/// cache: a block read by one of them is a hit for all others.
+///
+/// Blocks are keyed by the device, inode, size and modification time of the
+/// file, and by their offset. The first process creates the segment, with
+/// room for `capacity / block_size` blocks; the others use its capacity and
+/// block size. The segment persists until it's removed with `remove`.
+///
+/// Only files opened with `File::ReadOnly` are supported; opening a file for
+/// writing fails. The segment is protected by a robust process-shared mutex:
+/// if a process dies while holding it, the next process clears the cache.
+///
+///     FileAccessProps fapl;
+///     fapl.add(SharedBlockCache("/analysis_cache", 1 << 30));
+///     File file("data.h5", File::ReadOnly, fapl);
+///
+/// Before glibc 2.34, `shm_open` is in `librt`. The `HighFive` CMake target
+/// links it when needed, other builds must add `-lrt`.
+///
+class SharedBlockCache {
+  public:
+    ///
+    /// \param name The name of the shared memory segment, e.g. "/my_cache"
+    /// \param capacity The total size of the cache in bytes
+    /// \param block_size The size of a block in bytes
+    explicit SharedBlockCache(const std::string& name = "/highfive_block_cache",
+                              size_t capacity = 256 * 1024 * 1024,
+                              size_t block_size = 64 * 1024);
+    explicit SharedBlockCache(const FileAccessProps& fapl);
+
+    const std::string& getName() const noexcept;
+    size_t getCapacity() const noexcept;
+    size_t getBlockSize() const noexcept;
+
+    /// \brief The counters of the cache, which is created if needed.
+    BlockCacheStats getStats() const;
+
+    /// \brief Reset the counters of the cache to zero.
+    void resetStats() const;
+
+    ///
+    /// \brief Remove the shared memory segment `name`.
+    ///
+    /// Files which are open keep using the segment. Files opened afterwards
+    /// use a new segment.
+    static void remove(const std::string& name);
+
+  private:
+    friend FileAccessProps;
+    void apply(const hid_t list) const;
+
+    std::string _name;
+    size_t _capacity;
+    size_t _block_size;
+};
+
+}  // namespace HighFive
+
+#include "bits/H5SharedBlockCache_misc.hpp"
+
+#endif
@@ -0,0 +1,137 @@
+/*
+ *  Copyright (c), 2023, Blue Brain Project - EPFL
+ *
+ *  Distributed under the Boost Software License, Version 1.0.
+ *    (See accompanying file LICENSE_1_0.txt or copy at
+ *          http://www.boost.org/LICENSE_1_0.txt)
+ *
+ */
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "H5Exception.hpp"
+
+namespace HighFive {
+
+///
+/// \brief Records a timeline of the metadata calls of HighFive.
+///
+/// `IOTrace` tells which data is accessed; the timeline tells where the time
+/// goes when opening files and navigating them, e.g. when a job is slow to
+/// start. While the timeline is active, HighFive records a span for:
+///  - opening and closing a `File`, and `File::flush`;
+///  - `createDataSet`, `getDataSet`, `createGroup`, `getGroup`, `exist` and
+///    `listObjectNames`;
+///  - `createAttribute`, `getAttribute`, `Attribute::read` and
+///    `Attribute::write`.
+///
+/// The spans are written in the Chrome trace event format, which can be
+/// opened in `chrome://tracing` or https://ui.perfetto.dev. Every thread is
+/// shown on its own track; spans started inside other spans, e.g. the
+/// `createDataSet` which creates the dataset from the one which also writes
+/// the data, are nested.
+///
+///     Timeline::start("job.json");
+///     // ... run the job ...
+///     Timeline::stop();
+///
+/// Every thread appends to its own buffer, without taking a lock; the buffers
+/// are collected by `stop`. When the timeline isn't active, the overhead of a
+/// span is that of reading an atomic flag. To remove the spans entirely,
+/// define `HIGHFIVE_DISABLE_TIMELINE` before including HighFive.
+///
+class Timeline {
+  public:
+    /// \brief Start recording, the timeline is written to `filename` by `stop`.
+    ///
+    /// If the timeline is active, it's stopped first.
+    static void start(const std::string& filename);
+
+    /// \brief Stop recording and write the timeline.
+    static void stop();
+
+    /// \brief Is the timeline active?
+    static bool isActive() noexcept;
+
+    /// \brief Append a span called `name` to the buffer of the calling thread.
+    ///
+    /// `detail`, e.g. the name of a dataset, is shown with the span. Called by
+    /// `details::TimelineSpan`, there's usually no need to call this directly.
+    static void record(const char* name,
+                       const std::string& detail,
+                       std::chrono::steady_clock::time_point start,
+                       std::chrono::steady_clock::time_point stop) noexcept;
+};
+
+namespace details {
+
+///
+/// \brief Records a span over its scope if the timeline is active.
+///
+/// The name must be a string literal and `detail` must outlive the span. A
+/// null name records nothing.
+///
+class TimelineSpan {
+  public:
+    explicit TimelineSpan(const char* name) noexcept
+        : TimelineSpan(name, nullptr) {}
+
+    TimelineSpan(const char* name, const std::string& detail) noexcept
+        : TimelineSpan(name, &detail) {}
+
+    TimelineSpan(const TimelineSpan&) = delete;
+    TimelineSpan& operator=(const TimelineSpan&) = delete;
+
+    ~TimelineSpan() {
+        if (_active) {
+            static const std::string no_detail;
+            Timeline::record(_name,
+                             _detail != nullptr ? *_detail : no_detail,
+                             _start,
+                             std::chrono::steady_clock::now());
+        }
+    }
+
+  private:
+    TimelineSpan(const char* name, const std::string* detail) noexcept
+        : _active(name != nullptr && Timeline::isActive())
+        , _name(name)
+        , _detail(detail) {
+        if (_active) {
+            _start = std::chrono::steady_clock::now();
+        }
+    }
+
+    bool _active;
+    const char* _name;
+    const std::string* _detail;
+    std::chrono::steady_clock::time_point _start;
+};
+
+}  // namespace details
+
+}  // namespace HighFive
+
+#define HIGHFIVE_TIMELINE_CONCAT_IMPL(a, b) a##b
+#define HIGHFIVE_TIMELINE_CONCAT(a, b)      HIGHFIVE_TIMELINE_CONCAT_IMPL(a, b)
+
+/// \brief Records a span until the end of the enclosing scope.
+///
+/// Takes the arguments of the constructors of `details::TimelineSpan`.
+#ifndef HIGHFIVE_DISABLE_TIMELINE
+#define HIGHFIVE_TIMELINE_SPAN(...)                               \
+    ::HighFive::details::TimelineSpan HIGHFIVE_TIMELINE_CONCAT( \
+        highfive_timeline_span_, __LINE__)(__VA_ARGS__)
+#else
+#define HIGHFIVE_TIMELINE_SPAN(...) (void) 0
+#endif
+
+#include "bits/H5Timeline_misc.hpp"
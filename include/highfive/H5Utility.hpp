@@ -10,7 +10,12 @@
 #pragma once
 
 #include <H5Epublic.h>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
 #include <functional>
+#include <new>
 #include <string>
 #include <iostream>
 
@@ -39,6 +44,68 @@ class SilenceHDF5 {
     void* _client_data;
 };
 
+///
+/// \brief An allocator returning memory aligned to `Alignment` bytes.
+///
+/// Direct I/O, see `DirectIO`, requires buffers aligned to the block size of
+/// the file system. Any other buffer is copied to an aligned buffer first.
+/// Use as follows:
+///
+///     std::vector<double, AlignedAllocator<double>> x(n);
+///     dset.write_raw(x.data());
+///
+template <typename T, size_t Alignment = 4096>
+class AlignedAllocator {
+    static_assert(Alignment >= alignof(T) && (Alignment & (Alignment - 1)) == 0,
+                  "Alignment must be a power of two and a multiple of alignof(T).");
+
+  public:
+    using value_type = T;
+
+    template <typename U>
+    struct rebind {
+        using other = AlignedAllocator<U, Alignment>;
+    };
+
+    AlignedAllocator() = default;
+
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment>&) noexcept {}
+
+    inline T* allocate(size_t n) {
+        if (n > (size_t(-1) - Alignment - sizeof(void*)) / sizeof(T)) {
+            throw std::bad_alloc();
+        }
+
+        // Over-allocate and remember the pointer returned by `malloc` right
+        // before the aligned block.
+        void* raw = std::malloc(n * sizeof(T) + Alignment + sizeof(void*));
+        if (raw == nullptr) {
+            throw std::bad_alloc();
+        }
+        auto address = reinterpret_cast<std::uintptr_t>(raw) + sizeof(void*);
+        address = (address + Alignment - 1) & ~std::uintptr_t(Alignment - 1);
+        reinterpret_cast<void**>(address)[-1] = raw;
+        return reinterpret_cast<T*>(address);
+    }
+
+    inline void deallocate(T* ptr, size_t) noexcept {
+        if (ptr != nullptr) {
+            std::free(reinterpret_cast<void**>(ptr)[-1]);
+        }
+    }
+};
+
+template <typename T, typename U, size_t Alignment>
+inline bool operator==(const AlignedAllocator<T, Alignment>&, const AlignedAllocator<U, Alignment>&) {
+    return true;
+}
+
+template <typename T, typename U, size_t Alignment>
+inline bool operator!=(const AlignedAllocator<T, Alignment>&, const AlignedAllocator<U, Alignment>&) {
+    return false;
+}
+
 #define HIGHFIVE_LOG_LEVEL_DEBUG 10
 #define HIGHFIVE_LOG_LEVEL_INFO  20
 #define HIGHFIVE_LOG_LEVEL_WARN  30
@@ -48,6 +115,11 @@ class SilenceHDF5 {
 #define HIGHFIVE_LOG_LEVEL HIGHFIVE_LOG_LEVEL_WARN
 #endif
 
+// The default of `Logger::set_rate_limit`, no limit.
+#ifndef HIGHFIVE_LOG_RATE_LIMIT
+#define HIGHFIVE_LOG_RATE_LIMIT 0
+#endif
+
 enum class LogSeverity {
     Debug = HIGHFIVE_LOG_LEVEL_DEBUG,
     Info = HIGHFIVE_LOG_LEVEL_INFO,
@@ -83,12 +155,22 @@ inline std::string to_string(LogSeverity severity) {
  *   - `HIGHFIVE_LOG_ERROR{,_IF}`
  *
  * This is intended to used as a singleton, via `get_global_logger()`.
+ *
+ * Messages are only formatted if their severity is enabled, both at compile
+ * time, see `HIGHFIVE_LOG_LEVEL`, and at runtime, see `set_level`. If a rate
+ * limit is set, each call site logs at most `get_rate_limit()` messages per
+ * second; the number of messages dropped is appended to the next message
+ * logged. Call sites which would otherwise repeat a message on every call use
+ * `HIGHFIVE_LOG_WARN_LIMITED` with a limit of their own.
  */
 class Logger {
   public:
     using callback_type =
         std::function<void(LogSeverity, const std::string&, const std::string&, int)>;
 
+    /// The current time in nanoseconds, see `set_clock`.
+    using clock_type = int64_t (*)();
+
   public:
     Logger() = delete;
     Logger(const Logger&) = delete;
@@ -111,8 +193,57 @@ class Logger {
         _cb = std::move(cb);
     }
 
+    /// \brief Discard messages less severe than `severity`, before they're formatted.
+    ///
+    /// Messages below `HIGHFIVE_LOG_LEVEL` are always discarded.
+    inline void set_level(LogSeverity severity) noexcept {
+        _level.store(static_cast<int>(severity), std::memory_order_relaxed);
+    }
+
+    inline LogSeverity get_level() const noexcept {
+        return static_cast<LogSeverity>(_level.load(std::memory_order_relaxed));
+    }
+
+    inline bool is_enabled(LogSeverity severity) const noexcept {
+        return static_cast<int>(severity) >= _level.load(std::memory_order_relaxed);
+    }
+
+    /// \brief Log at most `max_messages` per second from every call site; 0 means no limit.
+    ///
+    /// The default is `HIGHFIVE_LOG_RATE_LIMIT`, i.e. no limit unless defined otherwise.
+    inline void set_rate_limit(unsigned max_messages) noexcept {
+        _rate_limit.store(max_messages, std::memory_order_relaxed);
+    }
+
+    inline unsigned get_rate_limit() const noexcept {
+        return _rate_limit.load(std::memory_order_relaxed);
+    }
+
+    /// \brief Measure the time of the rate limit with `clock`; `nullptr`
+    /// restores `std::chrono::steady_clock`.
+    ///
+    /// Meant for tests, which can then advance the time without waiting.
+    inline void set_clock(clock_type clock) noexcept {
+        _clock.store(clock != nullptr ? clock : &steady_clock_now, std::memory_order_relaxed);
+    }
+
+    /// \brief The current time of the rate limit, in nanoseconds.
+    inline int64_t now() const {
+        return _clock.load(std::memory_order_relaxed)();
+    }
+
   private:
+    static int64_t steady_clock_now() {
+        using std::chrono::duration_cast;
+        using std::chrono::nanoseconds;
+        return duration_cast<nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    }
+
     callback_type _cb;
+    std::atomic<int> _level{HIGHFIVE_LOG_LEVEL};
+    std::atomic<unsigned> _rate_limit{HIGHFIVE_LOG_RATE_LIMIT};
+    std::atomic<clock_type> _clock{&steady_clock_now};
 };
 
 inline void default_logging_callback(LogSeverity severity,
@@ -149,11 +280,86 @@ inline void log(LogSeverity severity,
     auto& logger = get_global_logger();
     logger.log(severity, message, file, line);
 }
+
+/// \brief Log a `message`, after `n_suppressed` messages of the same call site were dropped.
+inline void log(LogSeverity severity,
+                const std::string& message,
+                const std::string& file,
+                int line,
+                unsigned n_suppressed) {
+    if (n_suppressed == 0) {
+        log(severity, message, file, line);
+    } else {
+        log(severity,
+            message + " [" + std::to_string(n_suppressed) + " similar messages suppressed]",
+            file,
+            line);
+    }
+}
+
+/// \brief Limits the messages of a call site to `Logger::get_rate_limit()` per second.
+class LogRateLimiter {
+  public:
+    /// \brief Also limit the call site to `max_messages` per second, unless it's 0.
+    explicit LogRateLimiter(unsigned max_messages = 0) noexcept
+        : _max_messages(max_messages) {}
+
+    /// \brief May a message be logged? If so, `n_suppressed` is set to the
+    /// number of messages dropped since the last one logged.
+    bool allow(unsigned& n_suppressed) noexcept {
+        n_suppressed = 0;
+        const auto& logger = get_global_logger();
+        unsigned limit = logger.get_rate_limit();
+        if (_max_messages != 0 && (limit == 0 || _max_messages < limit)) {
+            limit = _max_messages;
+        }
+        if (limit == 0) {
+            return true;
+        }
+
+        const int64_t now = logger.now();
+        int64_t window_end = _window_end.load(std::memory_order_relaxed);
+        if (now >= window_end &&
+            _window_end.compare_exchange_strong(window_end, now + 1000000000)) {
+            _count.store(1, std::memory_order_relaxed);
+            n_suppressed = _n_suppressed.exchange(0, std::memory_order_relaxed);
+            return true;
+        }
+        if (_count.fetch_add(1, std::memory_order_relaxed) < limit) {
+            return true;
+        }
+        _n_suppressed.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+  private:
+    const unsigned _max_messages;
+    std::atomic<int64_t> _window_end{0};
+    std::atomic<unsigned> _count{0};
+    std::atomic<unsigned> _n_suppressed{0};
+};
 }  // namespace detail
 
+// Logs `message`, if `severity` is enabled and the rate limit of the call site
+// isn't reached, see `LogRateLimiter`. Otherwise, `message` isn't evaluated.
+#define HIGHFIVE_LOG_IMPL_LIMITED(severity, max_messages, message)                          \
+    do {                                                                                    \
+        if (::HighFive::get_global_logger().is_enabled(severity)) {                         \
+            static ::HighFive::detail::LogRateLimiter highfive_log_rate_limiter(            \
+                max_messages);                                                              \
+            unsigned highfive_log_n_suppressed = 0;                                         \
+            if (highfive_log_rate_limiter.allow(highfive_log_n_suppressed)) {               \
+                ::HighFive::detail::log(                                                    \
+                    severity, (message), __FILE__, __LINE__, highfive_log_n_suppressed);    \
+            }                                                                               \
+        }                                                                                   \
+    } while (false)
+
+#define HIGHFIVE_LOG_IMPL(severity, message) HIGHFIVE_LOG_IMPL_LIMITED(severity, 0, message)
+
 #if HIGHFIVE_LOG_LEVEL <= HIGHFIVE_LOG_LEVEL_DEBUG
 #define HIGHFIVE_LOG_DEBUG(message) \
-    ::HighFive::detail::log(::HighFive::LogSeverity::Debug, (message), __FILE__, __LINE__);
+    HIGHFIVE_LOG_IMPL(::HighFive::LogSeverity::Debug, message);
 
 // Useful, for the common pattern: if ...; then log something.
 #define HIGHFIVE_LOG_DEBUG_IF(cond, message) \
@@ -168,7 +374,7 @@ inline void log(LogSeverity severity,
 
 #if HIGHFIVE_LOG_LEVEL <= HIGHFIVE_LOG_LEVEL_INFO
 #define HIGHFIVE_LOG_INFO(message) \
-    ::HighFive::detail::log(::HighFive::LogSeverity::Info, (message), __FILE__, __LINE__);
+    HIGHFIVE_LOG_IMPL(::HighFive::LogSeverity::Info, message);
 
 // Useful, for the common pattern: if ...; then log something.
 #define HIGHFIVE_LOG_INFO_IF(cond, message) \
@@ -184,7 +390,7 @@ inline void log(LogSeverity severity,
 
 #if HIGHFIVE_LOG_LEVEL <= HIGHFIVE_LOG_LEVEL_WARN
 #define HIGHFIVE_LOG_WARN(message) \
-    ::HighFive::detail::log(::HighFive::LogSeverity::Warn, (message), __FILE__, __LINE__);
+    HIGHFIVE_LOG_IMPL(::HighFive::LogSeverity::Warn, message);
 
 // Useful, for the common pattern: if ...; then log something.
 #define HIGHFIVE_LOG_WARN_IF(cond, message) \
@@ -192,14 +398,19 @@ inline void log(LogSeverity severity,
         HIGHFIVE_LOG_WARN((message));       \
     }
 
+// At most `max_messages` per second, whatever `Logger::get_rate_limit()` is.
+#define HIGHFIVE_LOG_WARN_LIMITED(max_messages, message) \
+    HIGHFIVE_LOG_IMPL_LIMITED(::HighFive::LogSeverity::Warn, max_messages, message);
+
 #else
-#define HIGHFIVE_LOG_WARN(message)          ;
-#define HIGHFIVE_LOG_WARN_IF(cond, message) ;
+#define HIGHFIVE_LOG_WARN(message)                       ;
+#define HIGHFIVE_LOG_WARN_IF(cond, message)              ;
+#define HIGHFIVE_LOG_WARN_LIMITED(max_messages, message) ;
 #endif
 
 #if HIGHFIVE_LOG_LEVEL <= HIGHFIVE_LOG_LEVEL_ERROR
 #define HIGHFIVE_LOG_ERROR(message) \
-    ::HighFive::detail::log(::HighFive::LogSeverity::Error, (message), __FILE__, __LINE__);
+    HIGHFIVE_LOG_IMPL(::HighFive::LogSeverity::Error, message);
 
 // Useful, for the common pattern: if ...; then log something.
 #define HIGHFIVE_LOG_ERROR_IF(cond, message) \
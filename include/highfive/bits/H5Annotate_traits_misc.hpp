@@ -14,6 +14,7 @@
 #include <H5Apublic.h>
 #include <H5Ppublic.h>
 
+#include "../H5Timeline.hpp"
 #include "H5Attribute_misc.hpp"
 #include "H5Iterables_misc.hpp"
 
@@ -23,6 +24,7 @@ template <typename Derivate>
 inline Attribute AnnotateTraits<Derivate>::createAttribute(const std::string& attribute_name,
                                                            const DataSpace& space,
                                                            const DataType& dtype) {
+    HIGHFIVE_TIMELINE_SPAN("createAttribute", attribute_name);
     auto attr_id = H5Acreate2(static_cast<Derivate*>(this)->getId(),
                               attribute_name.c_str(),
                               dtype.getId(),
@@ -47,6 +49,7 @@ template <typename Derivate>
 template <typename T>
 inline Attribute AnnotateTraits<Derivate>::createAttribute(const std::string& attribute_name,
                                                            const T& data) {
+    HIGHFIVE_TIMELINE_SPAN("createAttribute", attribute_name);
     Attribute att =
         createAttribute(attribute_name,
                         DataSpace::From(data),
@@ -65,6 +68,7 @@ inline void AnnotateTraits<Derivate>::deleteAttribute(const std::string& attribu
 
 template <typename Derivate>
 inline Attribute AnnotateTraits<Derivate>::getAttribute(const std::string& attribute_name) const {
+    HIGHFIVE_TIMELINE_SPAN("getAttribute", attribute_name);
     const auto attr_id =
         H5Aopen(static_cast<const Derivate*>(this)->getId(), attribute_name.c_str(), H5P_DEFAULT);
     if (attr_id < 0) {
@@ -18,6 +18,7 @@
 #include <H5Ppublic.h>
 
 #include "../H5DataSpace.hpp"
+#include "../H5Timeline.hpp"
 #include "H5Converter_misc.hpp"
 #include "H5ReadWrite_misc.hpp"
 #include "H5Utils.hpp"
@@ -104,6 +105,7 @@ inline void Attribute::read(T* array, const DataType& mem_datatype) const {
     static_assert(!std::is_const<T>::value,
                   "read() requires a non-const structure to read data into");
 
+    HIGHFIVE_TIMELINE_SPAN("Attribute::read");
     if (H5Aread(getId(), mem_datatype.getId(), static_cast<void*>(array)) < 0) {
         HDF5ErrMapper::ToException<AttributeException>("Error during HDF5 Read: ");
     }
@@ -142,6 +144,7 @@ inline void Attribute::write(const T& buffer) {
 
 template <typename T>
 inline void Attribute::write_raw(const T* buffer, const DataType& mem_datatype) {
+    HIGHFIVE_TIMELINE_SPAN("Attribute::write");
     if (H5Awrite(getId(), mem_datatype.getId(), buffer) < 0) {
         HDF5ErrMapper::ToException<DataSetException>("Error during HDF5 Write: ");
     }
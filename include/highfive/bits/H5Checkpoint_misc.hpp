@@ -0,0 +1,418 @@
+/*
+ *  Copyright (c), 2023, Blue Brain Project - EPFL
+ *
+ *  Distributed under the Boost Software License, Version 1.0.
+ *    (See accompanying file LICENSE_1_0.txt or copy at
+ *          http://www.boost.org/LICENSE_1_0.txt)
+ *
+ */
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <thread>
+
+#include <H5Ppublic.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace HighFive {
+
+namespace details {
+
+// A fast, non-cryptographic 64-bit hash consuming eight bytes at a time.
+inline uint64_t hash_bytes(const char* data, size_t size) {
+    const uint64_t prime = 0x9E3779B97F4A7C15ull;
+    uint64_t hash = 0xCBF29CE484222325ull ^ (size * prime);
+
+    auto mix = [prime](uint64_t h, uint64_t word) {
+        h ^= word * prime;
+        h = (h << 31) | (h >> 33);
+        return h * 0xBF58476D1CE4E5B9ull;
+    };
+
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+        uint64_t word;
+        std::memcpy(&word, data + i, sizeof(word));
+        hash = mix(hash, word);
+    }
+
+    uint64_t tail = 0;
+    std::memcpy(&tail, data + i, size - i);
+    hash = mix(hash, tail);
+
+    hash ^= hash >> 32;
+    // Zero marks chunks which haven't been written yet.
+    return hash == 0 ? 1 : hash;
+}
+
+// Copies the tile `[offset, offset + count)` of the row-major array `src` of
+// shape `dims` into the contiguous buffer `dst`.
+inline void gather_tile(const char* src,
+                        const std::vector<size_t>& dims,
+                        const std::vector<size_t>& offset,
+                        const std::vector<size_t>& count,
+                        size_t element_size,
+                        char* dst) {
+    const size_t n_dims = dims.size();
+    const size_t row_size = count.back() * element_size;
+
+    size_t n_rows = 1;
+    for (size_t d = 0; d + 1 < n_dims; ++d) {
+        n_rows *= count[d];
+    }
+
+    // Iterate over all rows of the tile, i.e. over all indices but the last.
+    std::vector<size_t> index(n_dims, 0);
+    for (size_t row = 0; row < n_rows; ++row) {
+        size_t linear = 0;
+        for (size_t d = 0; d < n_dims; ++d) {
+            linear = linear * dims[d] + offset[d] + index[d];
+        }
+        std::memcpy(dst, src + linear * element_size, row_size);
+        dst += row_size;
+
+        for (size_t d = n_dims - 1; d-- > 0;) {
+            if (++index[d] < count[d]) {
+                break;
+            }
+            index[d] = 0;
+        }
+    }
+}
+
+// Writes the data of the file, or directory, `path` to stable storage.
+// Returns false if it can't be opened. Does nothing on other platforms.
+inline bool sync_path(const std::string& path, bool is_directory = false) {
+#if defined(__unix__) || defined(__APPLE__)
+    const int fd = ::open(path.c_str(), is_directory ? O_RDONLY : O_RDWR);
+    if (fd < 0) {
+        return false;
+    }
+    const int status = ::fsync(fd);
+    ::close(fd);
+    if (status != 0) {
+        throw FileException("CheckpointFile: unable to sync " + path);
+    }
+#else
+    (void) path;
+    (void) is_directory;
+#endif
+    return true;
+}
+
+// Writes the data of `file`, which has been flushed, to stable storage.
+inline void sync_file(const File& file) {
+#if defined(__unix__) || defined(__APPLE__)
+    const int fd = get_posix_file_descriptor(file.getId());
+    if (fd >= 0) {
+        if (::fsync(fd) != 0) {
+            throw FileException("CheckpointFile: unable to sync " + file.getName());
+        }
+        return;
+    }
+#endif
+    // Other drivers don't expose a file descriptor. Files which aren't
+    // stored under their name, e.g. with the family driver, can't be synced.
+    sync_path(file.getName());
+}
+
+// Replaces `dst` by `src`, atomically on POSIX systems.
+inline bool replace_file(const std::string& src, const std::string& dst) {
+#if !defined(__unix__) && !defined(__APPLE__)
+    // Elsewhere, e.g. on Windows, `std::rename` may not replace existing files.
+    std::remove(dst.c_str());
+#endif
+    return std::rename(src.c_str(), dst.c_str()) == 0;
+}
+
+inline std::string parent_directory(const std::string& path) {
+    const auto pos = path.find_last_of("/\\");
+    if (pos == std::string::npos) {
+        return ".";
+    }
+    return pos == 0 ? path.substr(0, 1) : path.substr(0, pos);
+}
+
+}  // namespace details
+
+template <typename Node>
+inline DeltaCheckpointer::DeltaCheckpointer(NodeTraits<Node>& node,
+                                            const std::string& dataset_name)
+    : _dataset(node.getDataSet(dataset_name))
+    , _hashes(node.exist(dataset_name + "_chunk_hashes")
+                  ? node.getDataSet(dataset_name + "_chunk_hashes")
+                  : node.template createDataSet<uint64_t>(
+                        dataset_name + "_chunk_hashes",
+                        DataSpace({0}, {DataSpace::UNLIMITED}),
+                        [] {
+                            DataSetCreateProps dcpl;
+                            dcpl.add(Chunking(std::vector<hsize_t>{4096}));
+                            return dcpl;
+                        }())) {
+    _loadLayout();
+}
+
+inline DeltaCheckpointer::DeltaCheckpointer(const DataSet& dataset, const DataSet& hashes)
+    : _dataset(dataset)
+    , _hashes(hashes) {
+    _loadLayout();
+}
+
+inline void DeltaCheckpointer::_loadLayout() {
+    auto dcpl = _dataset.getCreatePropertyList();
+    if (H5Pget_layout(dcpl.getId()) != H5D_CHUNKED) {
+        throw DataSetException("DeltaCheckpointer requires a chunked dataset.");
+    }
+
+    _dims = _dataset.getDimensions();
+    _chunk_dims = toSTLSizeVector(Chunking(dcpl).getDimensions());
+
+    if (_hashes.getDimensions().size() != 1) {
+        throw DataSetException("DeltaCheckpointer requires one-dimensional chunk hashes.");
+    }
+}
+
+inline size_t DeltaCheckpointer::getNumberChunks() const {
+    size_t n_chunks = 1;
+    for (auto n: _chunkGrid(_dataset.getDimensions())) {
+        n_chunks *= n;
+    }
+    return n_chunks;
+}
+
+template <typename T>
+inline size_t DeltaCheckpointer::write(const std::vector<T>& buffer, size_t n_threads) {
+    if (buffer.size() != _dataset.getElementCount()) {
+        throw DataSetException("DeltaCheckpointer: buffer size doesn't match the dataset.");
+    }
+    return write(buffer.data(), n_threads);
+}
+
+inline std::vector<uint64_t> DeltaCheckpointer::_chunkGrid(const std::vector<size_t>& dims) const {
+    std::vector<uint64_t> grid(dims.size());
+    for (size_t d = 0; d < dims.size(); ++d) {
+        grid[d] = (dims[d] + _chunk_dims[d] - 1) / _chunk_dims[d];
+    }
+    return grid;
+}
+
+inline void DeltaCheckpointer::_chunkTile(const std::vector<uint64_t>& grid,
+                                          size_t i,
+                                          std::vector<size_t>& offset,
+                                          std::vector<size_t>& count) const {
+    // `i` is the row-major index of the chunk in `grid`.
+    for (size_t d = _dims.size(); d-- > 0;) {
+        offset[d] = (i % grid[d]) * _chunk_dims[d];
+        count[d] = std::min(_chunk_dims[d], _dims[d] - offset[d]);
+        i /= grid[d];
+    }
+}
+
+template <typename T>
+inline size_t DeltaCheckpointer::write(const T* buffer, size_t n_threads) {
+    using element_type = typename details::inspector<T>::base_type;
+    const auto& mem_datatype = create_and_check_datatype<element_type>();
+
+    // The dataset might have been resized since the last write.
+    _dims = _dataset.getDimensions();
+    const size_t n_dims = _dims.size();
+    const auto grid = _chunkGrid(_dims);
+
+    size_t n_chunks = 1;
+    for (auto n: grid) {
+        n_chunks *= n;
+    }
+    if (n_chunks == 0) {
+        return 0;
+    }
+
+    // The hashes are stored in row-major order of the chunk grid at the time
+    // of the last write. Look them up by the coordinates of the chunks, since
+    // the grid changes when any dimension is resized.
+    std::vector<uint64_t> stored_grid;
+    if (_hashes.hasAttribute("chunk_grid")) {
+        _hashes.getAttribute("chunk_grid").read(stored_grid);
+    }
+    std::vector<uint64_t> stored_hashes;
+    if (stored_grid.size() == n_dims) {
+        _hashes.read(stored_hashes);
+    }
+
+    auto old_hashes = std::vector<uint64_t>(n_chunks, 0);
+    if (!stored_hashes.empty()) {
+        for (size_t i = 0; i < n_chunks; ++i) {
+            size_t old_index = 0;
+            bool is_stored = true;
+            for (size_t d = 0, stride = n_chunks; d < n_dims; ++d) {
+                stride /= grid[d];
+                const size_t coordinate = (i / stride) % grid[d];
+                is_stored = is_stored && coordinate < stored_grid[d];
+                old_index = old_index * stored_grid[d] + coordinate;
+            }
+            if (is_stored && old_index < stored_hashes.size()) {
+                old_hashes[i] = stored_hashes[old_index];
+            }
+        }
+    }
+
+    // Hashing is the bulk of the work when little changed, spread it over
+    // `n_threads` threads. Only the calling thread uses HDF5.
+    const char* src = reinterpret_cast<const char*>(buffer);
+    auto hashes = std::vector<uint64_t>(n_chunks, 0);
+    std::atomic<size_t> next_chunk{0};
+    auto hash_chunks = [&]() {
+        std::vector<char> tile;
+        std::vector<size_t> offset(n_dims), count(n_dims);
+        for (size_t i = next_chunk++; i < n_chunks; i = next_chunk++) {
+            _chunkTile(grid, i, offset, count);
+            size_t tile_size = sizeof(T);
+            for (auto c: count) {
+                tile_size *= c;
+            }
+            tile.resize(tile_size);
+            details::gather_tile(src, _dims, offset, count, sizeof(T), tile.data());
+            hashes[i] = details::hash_bytes(tile.data(), tile.size());
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (size_t t = 1; t < std::min(n_threads, n_chunks); ++t) {
+        workers.emplace_back(hash_chunks);
+    }
+    hash_chunks();
+    for (auto& worker: workers) {
+        worker.join();
+    }
+
+    std::vector<char> tile;
+    std::vector<size_t> offset(n_dims), count(n_dims);
+    size_t n_written = 0;
+    for (size_t i = 0; i < n_chunks; ++i) {
+        if (hashes[i] == old_hashes[i]) {
+            continue;
+        }
+
+        _chunkTile(grid, i, offset, count);
+        size_t tile_size = sizeof(T);
+        for (auto c: count) {
+            tile_size *= c;
+        }
+        tile.resize(tile_size);
+        details::gather_tile(src, _dims, offset, count, sizeof(T), tile.data());
+        _dataset.select(offset, count)
+            .write_raw(reinterpret_cast<const T*>(tile.data()), mem_datatype);
+        ++n_written;
+    }
+
+    const bool grid_changed = stored_grid != grid;
+    if (_hashes.getElementCount() != n_chunks) {
+        _hashes.resize({n_chunks});
+    }
+    if (n_written > 0 || grid_changed || stored_hashes.size() != n_chunks) {
+        _hashes.write(hashes);
+    }
+    if (grid_changed) {
+        if (_hashes.hasAttribute("chunk_grid")) {
+            _hashes.deleteAttribute("chunk_grid");
+        }
+        _hashes.createAttribute("chunk_grid", grid);
+    }
+
+    return n_written;
+}
+
+inline CheckpointFile::CheckpointFile(const std::string& prefix,
+                                      const FileAccessProps& fileAccessProps)
+    : _prefix(prefix)
+    , _fapl(fileAccessProps) {
+    std::ifstream manifest(_manifestPath());
+    int index = -1;
+    if (manifest >> index && (index == 0 || index == 1)) {
+        _latest = index;
+    }
+}
+
+inline std::string CheckpointFile::_backingPath(int index) const {
+    return _prefix + "." + std::to_string(index) + ".h5";
+}
+
+inline std::string CheckpointFile::_manifestPath() const {
+    return _prefix + ".manifest";
+}
+
+inline File CheckpointFile::beginCheckpoint() {
+    _pending = (_latest == 0) ? 1 : 0;
+    const auto path = _backingPath(_pending);
+
+    {
+        SilenceHDF5 silencer;
+        try {
+            return File(path, File::ReadWrite, _fapl);
+        } catch (const FileException&) {
+            // Missing or unusable, create it from scratch below.
+        }
+    }
+    return File(path, File::Truncate, _fapl);
+}
+
+inline void CheckpointFile::commit(File& file) {
+    if (_pending < 0) {
+        throw FileException("CheckpointFile: commit without beginCheckpoint.");
+    }
+    if (file.getName() != _backingPath(_pending)) {
+        throw FileException("CheckpointFile: " + file.getName() +
+                            " isn't the file returned by beginCheckpoint.");
+    }
+
+    // The checkpoint must be on disk before the manifest names it, and the
+    // manifest before the rename making it visible.
+    file.flush();
+    details::sync_file(file);
+
+    const auto manifest_path = _manifestPath();
+    const auto tmp_path = manifest_path + ".tmp";
+    {
+        std::ofstream manifest(tmp_path, std::ios::trunc);
+        manifest << _pending << "\n";
+        manifest.flush();
+        if (!manifest) {
+            throw FileException("CheckpointFile: unable to write " + tmp_path);
+        }
+    }
+    if (!details::sync_path(tmp_path)) {
+        throw FileException("CheckpointFile: unable to sync " + tmp_path);
+    }
+
+    if (!details::replace_file(tmp_path, manifest_path)) {
+        throw FileException("CheckpointFile: unable to update " + manifest_path);
+    }
+    details::sync_path(details::parent_directory(manifest_path), true);
+
+    _latest = _pending;
+    _pending = -1;
+}
+
+inline bool CheckpointFile::hasCheckpoint() const {
+    return _latest >= 0;
+}
+
+inline std::string CheckpointFile::getLatestPath() const {
+    if (!hasCheckpoint()) {
+        throw FileException("CheckpointFile: no checkpoint has been committed to " + _prefix);
+    }
+    return _backingPath(_latest);
+}
+
+inline File CheckpointFile::openLatest(unsigned openFlags) const {
+    return File(getLatestPath(), openFlags, _fapl);
+}
+
+}  // namespace HighFive
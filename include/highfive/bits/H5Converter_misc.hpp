@@ -8,11 +8,73 @@
  */
 #pragma once
 
+#include <atomic>
+#include <memory>
+
 #include "H5Inspector_misc.hpp"
 
 namespace HighFive {
 namespace details {
 
+// The bytes currently held by the staging buffers, i.e. the buffers in which
+// data is converted to and from the layout passed to HDF5, and their peak.
+// Only counted if `HIGHFIVE_TRACK_STAGING_MEMORY` is defined.
+struct StagingCounters {
+    std::atomic<size_t> size{0};
+    std::atomic<size_t> peak_size{0};
+};
+
+inline StagingCounters& get_staging_counters() {
+    static StagingCounters counters;
+    return counters;
+}
+
+// Allocates the staging buffers, while keeping track of their size if
+// `HIGHFIVE_TRACK_STAGING_MEMORY` is defined.
+template <typename T>
+struct StagingAllocator {
+    using value_type = T;
+
+    StagingAllocator() = default;
+
+    template <typename U>
+    StagingAllocator(const StagingAllocator<U>&) noexcept {}
+
+    T* allocate(std::size_t n) {
+        T* ptr = std::allocator<T>().allocate(n);
+#ifdef HIGHFIVE_TRACK_STAGING_MEMORY
+        auto& counters = get_staging_counters();
+        const size_t bytes = n * sizeof(T);
+        const size_t size = counters.size.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+        size_t peak = counters.peak_size.load(std::memory_order_relaxed);
+        while (size > peak && !counters.peak_size.compare_exchange_weak(
+                                  peak, size, std::memory_order_relaxed)) {
+        }
+#endif
+        return ptr;
+    }
+
+    void deallocate(T* ptr, std::size_t n) noexcept {
+#ifdef HIGHFIVE_TRACK_STAGING_MEMORY
+        get_staging_counters().size.fetch_sub(n * sizeof(T), std::memory_order_relaxed);
+#endif
+        std::allocator<T>().deallocate(ptr, n);
+    }
+};
+
+template <typename T, typename U>
+inline bool operator==(const StagingAllocator<T>&, const StagingAllocator<U>&) {
+    return true;
+}
+
+template <typename T, typename U>
+inline bool operator!=(const StagingAllocator<T>&, const StagingAllocator<U>&) {
+    return false;
+}
+
+template <typename T>
+using staging_vector = std::vector<T, StagingAllocator<T>>;
+
 template <typename T>
 struct Writer {
     using hdf5_type = typename inspector<T>::hdf5_type;
@@ -23,7 +85,7 @@ struct Writer {
             return vec.data();
         }
     }
-    std::vector<hdf5_type> vec{};
+    staging_vector<hdf5_type> vec{};
     const hdf5_type* ptr{nullptr};
 };
 
@@ -51,7 +113,7 @@ struct Reader {
     }
 
     std::vector<size_t> dims{};
-    std::vector<hdf5_type> vec{};
+    staging_vector<hdf5_type> vec{};
     type& val{};
 };
 
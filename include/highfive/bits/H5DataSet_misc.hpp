@@ -9,15 +9,29 @@
 #pragma once
 
 #include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <exception>
 #include <functional>
+#include <mutex>
 #include <numeric>
 #include <sstream>
 #include <string>
+#include <thread>
+#include <type_traits>
 
 #include <H5Dpublic.h>
+#include <H5FDpublic.h>
+#include <H5FDsec2.h>
 #include <H5Ppublic.h>
 
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#endif
+
 #include "H5Utils.hpp"
+#include "../H5Utility.hpp"
 
 namespace HighFive {
 
@@ -49,6 +63,30 @@ inline uint64_t DataSet::getOffset() const {
     return addr;
 }
 
+#ifdef H5_HAVE_DIRECT
+// Doesn't use `getFile`, the `File` it opens would keep the file open.
+inline size_t DataSet::_getDirectIOAlignment() const {
+    if (!_has_direct_io_alignment) {
+        size_t alignment = 0, block_size = 0, cbuf_size = 0;
+        const hid_t file_id = H5Iget_file_id(_hid);
+        const hid_t fapl_id = file_id < 0 ? H5I_INVALID_HID : H5Fget_access_plist(file_id);
+        if (fapl_id < 0 || H5Pget_driver(fapl_id) != H5FD_DIRECT ||
+            H5Pget_fapl_direct(fapl_id, &alignment, &block_size, &cbuf_size) < 0) {
+            alignment = 0;
+        }
+        if (fapl_id >= 0) {
+            H5Pclose(fapl_id);
+        }
+        if (file_id >= 0) {
+            H5Fclose(file_id);
+        }
+        _direct_io_alignment = alignment;
+        _has_direct_io_alignment = true;
+    }
+    return _direct_io_alignment;
+}
+#endif
+
 inline void DataSet::resize(const std::vector<size_t>& dims) {
     const size_t numDimensions = getSpace().getDimensions().size();
     if (dims.size() != numDimensions) {
@@ -64,4 +102,713 @@ inline void DataSet::resize(const std::vector<size_t>& dims) {
     }
 }
 
+namespace details {
+
+// Whether the handle of files opened with `driver` is a POSIX file descriptor,
+// e.g. for sec2 and the IoUringDriver.
+inline bool has_posix_file_descriptor(hid_t driver) {
+    if (driver == H5FD_SEC2) {
+        return true;
+    }
+#if H5_VERSION_GE(1, 10, 0)
+    unsigned long flags = 0;
+    return driver >= 0 && H5FDdriver_query(driver, &flags) >= 0 &&
+           (flags & H5FD_FEAT_POSIX_COMPAT_HANDLE) != 0;
+#else
+    return false;
+#endif
+}
+
+// Returns the file descriptor of the file containing `hid` if, and only if,
+// it's opened with a driver whose handle is a file descriptor. Otherwise -1.
+inline int get_posix_file_descriptor(hid_t hid) {
+    hid_t file_id = H5Iget_file_id(hid);
+    if (file_id < 0) {
+        HDF5ErrMapper::ToException<DataSetException>("Unable to get the file of the DataSet.");
+    }
+
+    int fd = -1;
+    hid_t fapl_id = H5Fget_access_plist(file_id);
+    if (fapl_id >= 0 && has_posix_file_descriptor(H5Pget_driver(fapl_id))) {
+        void* handle = nullptr;
+        if (H5Fget_vfd_handle(file_id, fapl_id, &handle) >= 0 && handle != nullptr) {
+            fd = *static_cast<int*>(handle);
+        }
+    }
+
+    if (fapl_id >= 0) {
+        H5Pclose(fapl_id);
+    }
+    H5Fclose(file_id);
+    return fd;
+}
+
+inline size_t advise_will_need(int fd, haddr_t begin, haddr_t end) {
+#if defined(POSIX_FADV_WILLNEED)
+    if (end > begin &&
+        posix_fadvise(fd, off_t(begin), off_t(end - begin), POSIX_FADV_WILLNEED) == 0) {
+        return size_t(end - begin);
+    }
+#else
+    (void) fd;
+    (void) begin;
+    (void) end;
+#endif
+    return 0;
+}
+
+// Hints the runs of consecutive elements of the hyperslab `offset`, `count` of
+// a contiguous dataset of shape `dims`, stored at `addr`. Runs less than a page
+// apart are merged, the pages between them are read anyway.
+inline size_t advise_will_need_contiguous(int fd,
+                                          haddr_t addr,
+                                          size_t element_size,
+                                          const std::vector<size_t>& dims,
+                                          const std::vector<size_t>& offset,
+                                          const std::vector<size_t>& count) {
+    const size_t n_dims = dims.size();
+    std::vector<haddr_t> strides(n_dims);
+    haddr_t stride = element_size;
+    for (size_t d = n_dims; d-- > 0;) {
+        strides[d] = stride;
+        stride *= dims[d];
+    }
+
+    // The run covers the dimensions from `n_outer` on: the trailing ones which
+    // are selected entirely, and the one before them.
+    haddr_t run = element_size;
+    size_t n_outer = n_dims;
+    while (n_outer > 0) {
+        --n_outer;
+        run *= count[n_outer];
+        if (count[n_outer] != dims[n_outer]) {
+            break;
+        }
+    }
+
+    const haddr_t page_size = 4096;
+    size_t n_hinted = 0;
+    haddr_t begin = HADDR_UNDEF, end = HADDR_UNDEF;
+
+    std::vector<size_t> index(offset.begin(), offset.begin() + std::ptrdiff_t(n_outer));
+    while (true) {
+        haddr_t start = addr;
+        for (size_t d = 0; d < n_dims; ++d) {
+            start += (d < n_outer ? index[d] : offset[d]) * strides[d];
+        }
+
+        if (begin != HADDR_UNDEF && start <= end + page_size) {
+            end = start + run;
+        } else {
+            if (begin != HADDR_UNDEF) {
+                n_hinted += advise_will_need(fd, begin, end);
+            }
+            begin = start;
+            end = start + run;
+        }
+
+        size_t d = n_outer;
+        while (d-- > 0) {
+            if (++index[d] < offset[d] + count[d]) {
+                break;
+            }
+            index[d] = offset[d];
+        }
+        if (d == size_t(-1)) {
+            break;
+        }
+    }
+
+    return n_hinted + advise_will_need(fd, begin, end);
+}
+
+}  // namespace details
+
+inline size_t DataSet::adviseWillNeed() const {
+    const auto dims = getDimensions();
+    return adviseWillNeed(std::vector<size_t>(dims.size(), 0), dims);
+}
+
+inline size_t DataSet::adviseWillNeed(const std::vector<size_t>& offset,
+                                      const std::vector<size_t>& count) const {
+    const auto dims = getDimensions();
+    if (offset.size() != dims.size() || count.size() != dims.size()) {
+        throw DataSetException("Invalid dimensions of the hyperslab.");
+    }
+    for (size_t d = 0; d < dims.size(); ++d) {
+        if (offset[d] > dims[d] || count[d] > dims[d] - offset[d]) {
+            throw DataSetException("The hyperslab exceeds the dimensions of the dataset.");
+        }
+    }
+    if (std::find(count.begin(), count.end(), size_t(0)) != count.end()) {
+        return 0;
+    }
+
+    const int fd = details::get_posix_file_descriptor(_hid);
+    if (fd < 0) {
+        return 0;
+    }
+
+    auto dcpl = getCreatePropertyList();
+    const auto layout = H5Pget_layout(dcpl.getId());
+
+    if (layout == H5D_CONTIGUOUS) {
+        haddr_t addr = H5Dget_offset(_hid);
+        if (addr == HADDR_UNDEF) {
+            return 0;
+        }
+        return details::advise_will_need_contiguous(
+            fd, addr, getDataType().getSize(), dims, offset, count);
+    }
+
+#if H5_VERSION_GE(1, 10, 5)
+    if (layout != H5D_CHUNKED) {
+        return 0;
+    }
+
+    const auto chunk_dims = Chunking(dcpl).getDimensions();
+    const size_t n_dims = dims.size();
+
+    std::vector<hsize_t> first_chunk(n_dims), last_chunk(n_dims);
+    for (size_t d = 0; d < n_dims; ++d) {
+        first_chunk[d] = offset[d] / chunk_dims[d];
+        last_chunk[d] = (offset[d] + count[d] - 1) / chunk_dims[d];
+    }
+
+    // Chunks are usually stored in the order they were written. Merging
+    // adjacent chunks keeps the number of syscalls low.
+    size_t n_hinted = 0;
+    haddr_t begin = HADDR_UNDEF, end = HADDR_UNDEF;
+
+    std::vector<hsize_t> chunk_index = first_chunk;
+    std::vector<hsize_t> chunk_offset(n_dims);
+    while (true) {
+        for (size_t d = 0; d < n_dims; ++d) {
+            chunk_offset[d] = chunk_index[d] * chunk_dims[d];
+        }
+
+        unsigned filter_mask = 0;
+        haddr_t addr = HADDR_UNDEF;
+        hsize_t size = 0;
+        if (H5Dget_chunk_info_by_coord(
+                _hid, chunk_offset.data(), &filter_mask, &addr, &size) < 0) {
+            HDF5ErrMapper::ToException<DataSetException>("Unable to get chunk info.");
+        }
+
+        if (addr != HADDR_UNDEF && size > 0) {
+            if (begin != HADDR_UNDEF && addr == end) {
+                end += size;
+            } else {
+                if (begin != HADDR_UNDEF) {
+                    n_hinted += details::advise_will_need(fd, begin, end);
+                }
+                begin = addr;
+                end = addr + size;
+            }
+        }
+
+        size_t d = n_dims;
+        while (d-- > 0) {
+            if (++chunk_index[d] <= last_chunk[d]) {
+                break;
+            }
+            chunk_index[d] = first_chunk[d];
+        }
+        if (d == size_t(-1)) {
+            break;
+        }
+    }
+
+    if (begin != HADDR_UNDEF) {
+        n_hinted += details::advise_will_need(fd, begin, end);
+    }
+    return n_hinted;
+#else
+    return 0;
+#endif
+}
+
+namespace details {
+
+// Calls `f(offset)` for the offset of every chunk of the grid covering `dims`,
+// in row-major order.
+template <typename F>
+inline void for_each_chunk_offset(const std::vector<size_t>& dims,
+                                  const std::vector<hsize_t>& chunk_dims,
+                                  F&& f) {
+    const size_t n_dims = dims.size();
+    if (std::find(dims.begin(), dims.end(), size_t(0)) != dims.end()) {
+        return;
+    }
+
+    std::vector<size_t> offset(n_dims, 0);
+    while (true) {
+        f(offset);
+
+        size_t d = n_dims;
+        while (d-- > 0) {
+            offset[d] += chunk_dims[d];
+            if (offset[d] < dims[d]) {
+                break;
+            }
+            offset[d] = 0;
+        }
+        if (d == size_t(-1)) {
+            return;
+        }
+    }
+}
+
+inline void append_chunk(ChunkTable& table,
+                         const hsize_t* offset,
+                         unsigned filter_mask,
+                         haddr_t addr,
+                         hsize_t size) {
+    table.offsets.insert(table.offsets.end(), offset, offset + table.n_dims);
+    table.addresses.push_back(addr);
+    table.sizes.push_back(size);
+    table.filter_masks.push_back(filter_mask);
+}
+
+#if H5_VERSION_GE(1, 14, 0)
+inline int append_chunk_info(
+    const hsize_t* offset, unsigned filter_mask, haddr_t addr, hsize_t size, void* op_data) {
+    try {
+        append_chunk(*static_cast<ChunkTable*>(op_data), offset, filter_mask, addr, size);
+    } catch (...) {
+        return H5_ITER_ERROR;
+    }
+    return H5_ITER_CONT;
+}
+#endif
+
+}  // namespace details
+
+inline ChunkTable DataSet::getChunkInfo() const {
+    auto dcpl = getCreatePropertyList();
+    if (H5Pget_layout(dcpl.getId()) != H5D_CHUNKED) {
+        throw DataSetException("getChunkInfo: the dataset " + getPath() + " isn't chunked.");
+    }
+
+    ChunkTable table;
+    const auto space = getSpace();
+    table.n_dims = space.getNumberDimensions();
+
+#if H5_VERSION_GE(1, 14, 0)
+    if (H5Dchunk_iter(_hid, H5P_DEFAULT, &details::append_chunk_info, &table) < 0) {
+        HDF5ErrMapper::ToException<DataSetException>("Unable to iterate over the chunks.");
+    }
+#elif H5_VERSION_GE(1, 10, 5)
+    hsize_t n_chunks = 0;
+    if (H5Dget_num_chunks(_hid, space.getId(), &n_chunks) < 0) {
+        HDF5ErrMapper::ToException<DataSetException>("Unable to get the number of chunks.");
+    }
+
+    table.offsets.reserve(n_chunks * table.n_dims);
+    table.addresses.reserve(n_chunks);
+    table.sizes.reserve(n_chunks);
+    table.filter_masks.reserve(n_chunks);
+
+    // Each call walks the chunk index from its start, see the documentation.
+    std::vector<hsize_t> offset(table.n_dims);
+    for (hsize_t i = 0; i < n_chunks; ++i) {
+        unsigned filter_mask = 0;
+        haddr_t addr = HADDR_UNDEF;
+        hsize_t size = 0;
+        if (H5Dget_chunk_info(
+                _hid, space.getId(), i, offset.data(), &filter_mask, &addr, &size) < 0) {
+            HDF5ErrMapper::ToException<DataSetException>("Unable to get chunk info.");
+        }
+        if (addr != HADDR_UNDEF) {
+            details::append_chunk(table, offset.data(), filter_mask, addr, size);
+        }
+    }
+#else
+    throw DataSetException("getChunkInfo: requires HDF5 1.10.5 or later.");
+#endif
+    return table;
+}
+
+inline DataSetStorageReport DataSet::getStorageReport() const {
+    DataSetStorageReport report;
+    report.path = getPath();
+
+    auto dcpl = getCreatePropertyList();
+    report.layout = H5Pget_layout(dcpl.getId());
+    if (report.layout < 0) {
+        HDF5ErrMapper::ToException<DataSetException>("Unable to get the layout of the dataset.");
+    }
+
+    const auto dims = getDimensions();
+    const size_t element_size = getDataType().getSize();
+    report.data_size = element_size;
+    for (auto dim: dims) {
+        report.data_size *= dim;
+    }
+    report.storage_size = getStorageSize();
+
+    if (report.layout != H5D_CHUNKED) {
+        report.n_chunks = 1;
+        report.n_allocated_chunks = report.storage_size > 0 ? 1 : 0;
+        report.allocated_size = report.n_allocated_chunks > 0 ? report.data_size : 0;
+        if (report.layout == H5D_CONTIGUOUS && report.n_allocated_chunks > 0) {
+            report.n_extents = 1;
+            report.extent_size = report.storage_size;
+        }
+        return report;
+    }
+
+    const auto chunk_dims = Chunking(dcpl).getDimensions();
+    uint64_t chunk_size = element_size;
+    report.n_chunks = 1;
+    for (size_t d = 0; d < dims.size(); ++d) {
+        chunk_size *= chunk_dims[d];
+        report.n_chunks *= (dims[d] + chunk_dims[d] - 1) / chunk_dims[d];
+    }
+
+    const auto table = getChunkInfo();
+    report.n_allocated_chunks = table.size();
+    report.allocated_size = table.size() * chunk_size;
+
+    // Chunks of the dataset stored back to back form a single extent.
+    std::vector<size_t> order(table.size());
+    std::iota(order.begin(), order.end(), size_t(0));
+    std::sort(order.begin(), order.end(), [&table](size_t a, size_t b) {
+        return table.addresses[a] < table.addresses[b];
+    });
+    uint64_t end = 0;
+    for (auto i: order) {
+        if (report.n_extents == 0 || table.addresses[i] != end) {
+            ++report.n_extents;
+        }
+        end = table.addresses[i] + table.sizes[i];
+    }
+    if (!order.empty()) {
+        report.extent_size = end - table.addresses[order.front()];
+    }
+    return report;
+}
+
+namespace details {
+
+struct ChunkLocation {
+    std::vector<size_t> offset;
+    haddr_t address;
+};
+
+// Before HDF5 1.14, `getChunkInfo` is quadratic in the number of chunks. Up to
+// this many chunks it takes a fraction of a second, which is made up for by
+// reading the chunks in the order they're stored.
+constexpr hsize_t max_sorted_chunks = 4096;
+
+// The allocated chunks of a chunked dataset, sorted by their address in the
+// file. Before HDF5 1.14, only up to `max_sorted_chunks` chunks are sorted.
+// Larger datasets, like all datasets before HDF5 1.10.5, have the chunks of
+// the grid looked up one by one, in row-major order, without their address.
+// Before HDF5 1.10.2, all chunks of the grid.
+inline std::vector<ChunkLocation> get_chunk_locations(const DataSet& dataset,
+                                                      const std::vector<size_t>& dims,
+                                                      const std::vector<hsize_t>& chunk_dims) {
+    std::vector<ChunkLocation> chunks;
+
+#if H5_VERSION_GE(1, 10, 5)
+    bool sorted = true;
+#if !H5_VERSION_GE(1, 14, 0)
+    hsize_t n_chunks = 0;
+    sorted = H5Dget_num_chunks(dataset.getId(), dataset.getSpace().getId(), &n_chunks) >= 0 &&
+             n_chunks <= max_sorted_chunks;
+#endif
+    if (sorted) {
+        const auto table = dataset.getChunkInfo();
+        chunks.reserve(table.size());
+        for (size_t i = 0; i < table.size(); ++i) {
+            chunks.push_back({table.offset(i), table.addresses[i]});
+        }
+
+        std::sort(chunks.begin(), chunks.end(), [](const ChunkLocation& a, const ChunkLocation& b) {
+            return a.address < b.address;
+        });
+        return chunks;
+    }
+#endif
+
+#if H5_VERSION_GE(1, 10, 2)
+    // Some versions fail, instead of returning 0, for chunks which aren't allocated.
+    SilenceHDF5 silencer;
+    std::vector<hsize_t> chunk_offset(dims.size());
+    for_each_chunk_offset(dims, chunk_dims, [&](const std::vector<size_t>& offset) {
+        std::copy(offset.begin(), offset.end(), chunk_offset.begin());
+        hsize_t size = 0;
+        if (H5Dget_chunk_storage_size(dataset.getId(), chunk_offset.data(), &size) >= 0 &&
+            size > 0) {
+            chunks.push_back({offset, HADDR_UNDEF});
+        }
+    });
+#else
+    (void) dataset;
+    for_each_chunk_offset(dims, chunk_dims, [&chunks](const std::vector<size_t>& offset) {
+        chunks.push_back({offset, HADDR_UNDEF});
+    });
+#endif
+    return chunks;
+}
+
+// Reads the chunks on the calling thread and passes them to `callback` on
+// `n_threads` workers. At most two chunks per worker are held in memory.
+template <typename T, typename Read, typename F>
+inline void run_chunk_workers(const std::vector<ChunkLocation>& chunks,
+                              Read&& read_chunk,
+                              F& callback,
+                              size_t n_threads) {
+    struct Task {
+        const ChunkLocation* chunk;
+        std::vector<size_t> count;
+        std::vector<T> data;
+    };
+
+    std::mutex mutex;
+    std::condition_variable ready, available;
+    std::deque<Task> tasks;
+    std::vector<Task> free_tasks(2 * n_threads);
+    bool done = false;
+    std::exception_ptr error;
+
+    auto work = [&]() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            ready.wait(lock, [&]() { return done || error || !tasks.empty(); });
+            if (error || tasks.empty()) {
+                return;
+            }
+            Task task = std::move(tasks.front());
+            tasks.pop_front();
+            lock.unlock();
+
+            try {
+                callback(task.chunk->offset, task.count, static_cast<const T*>(task.data.data()));
+            } catch (...) {
+                lock.lock();
+                if (!error) {
+                    error = std::current_exception();
+                }
+                ready.notify_all();
+                available.notify_all();
+                return;
+            }
+
+            lock.lock();
+            free_tasks.push_back(std::move(task));
+            available.notify_one();
+        }
+    };
+
+    std::vector<std::thread> workers;
+    auto stop = [&]() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            done = true;
+        }
+        ready.notify_all();
+        for (auto& worker: workers) {
+            worker.join();
+        }
+    };
+
+    try {
+        for (size_t i = 0; i < n_threads; ++i) {
+            workers.emplace_back(work);
+        }
+
+        for (const auto& chunk: chunks) {
+            Task task;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                available.wait(lock, [&]() { return error || !free_tasks.empty(); });
+                if (error) {
+                    break;
+                }
+                task = std::move(free_tasks.back());
+                free_tasks.pop_back();
+            }
+
+            task.chunk = &chunk;
+            read_chunk(chunk, task.count, task.data);
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                tasks.push_back(std::move(task));
+            }
+            ready.notify_one();
+        }
+    } catch (...) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!error) {
+                error = std::current_exception();
+            }
+        }
+        stop();
+        std::rethrow_exception(error);
+    }
+
+    stop();
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+}  // namespace details
+
+template <typename T, typename F>
+inline size_t DataSet::forEachChunk(F&& callback, size_t n_threads) const {
+    const auto dims = getDimensions();
+    const size_t n_dims = dims.size();
+    if (getElementCount() == 0) {
+        return 0;
+    }
+
+    const DataType mem_datatype = create_and_check_datatype<T>();
+    auto dcpl = getCreatePropertyList();
+
+    std::vector<details::ChunkLocation> chunks;
+    std::vector<hsize_t> chunk_dims(dims.begin(), dims.end());
+    if (H5Pget_layout(dcpl.getId()) == H5D_CHUNKED) {
+        chunk_dims = Chunking(dcpl).getDimensions();
+        chunks = details::get_chunk_locations(*this, dims, chunk_dims);
+    } else {
+        chunks.push_back({std::vector<size_t>(n_dims, 0), HADDR_UNDEF});
+    }
+
+    auto read_chunk = [&](const details::ChunkLocation& chunk,
+                          std::vector<size_t>& count,
+                          std::vector<T>& data) {
+        count.resize(n_dims);
+        size_t n_elements = 1;
+        for (size_t d = 0; d < n_dims; ++d) {
+            count[d] = std::min(size_t(chunk_dims[d]), dims[d] - chunk.offset[d]);
+            n_elements *= count[d];
+        }
+        data.resize(n_elements);
+        if (n_dims == 0) {
+            read(data.data(), mem_datatype);
+        } else {
+            select(chunk.offset, count).read(data.data(), mem_datatype);
+        }
+    };
+
+    if (n_threads <= 1) {
+        std::vector<size_t> count;
+        std::vector<T> data;
+        for (const auto& chunk: chunks) {
+            read_chunk(chunk, count, data);
+            callback(chunk.offset, count, static_cast<const T*>(data.data()));
+        }
+    } else {
+        details::run_chunk_workers<T>(chunks, read_chunk, callback, n_threads);
+    }
+    return chunks.size();
+}
+
+template <typename T>
+inline std::vector<SparseBlock<T>> DataSet::readSparse() const {
+    std::vector<SparseBlock<T>> blocks;
+    forEachChunk<T>([&blocks](const std::vector<size_t>& offset,
+                              const std::vector<size_t>& count,
+                              const T* data) {
+        const size_t n_elements =
+            std::accumulate(count.begin(), count.end(), size_t(1), std::multiplies<size_t>());
+        blocks.push_back({offset, count, std::vector<T>(data, data + n_elements)});
+    });
+
+    std::sort(blocks.begin(), blocks.end(), [](const SparseBlock<T>& a, const SparseBlock<T>& b) {
+        return a.offset < b.offset;
+    });
+    return blocks;
+}
+
+namespace details {
+
+// Fills `array` with the fill value of the dataset, converted to `mem_datatype`.
+template <typename T>
+inline void fill_with_fill_value(const DataSetCreateProps& dcpl,
+                                 const DataType& mem_datatype,
+                                 T* array,
+                                 size_t n_elements) {
+    std::vector<char> value(sizeof(T), 0);
+    H5D_fill_value_t status;
+    if (H5Pfill_value_defined(dcpl.getId(), &status) < 0) {
+        HDF5ErrMapper::ToException<PropertyException>("Unable to get the fill value status.");
+    }
+    if (status != H5D_FILL_VALUE_UNDEFINED &&
+        H5Pget_fill_value(dcpl.getId(), mem_datatype.getId(), value.data()) < 0) {
+        HDF5ErrMapper::ToException<PropertyException>("Unable to get the fill value.");
+    }
+
+    if (std::all_of(value.begin(), value.end(), [](char c) { return c == 0; })) {
+        std::memset(static_cast<void*>(array), 0, n_elements * sizeof(T));
+        return;
+    }
+    T fill;
+    std::memcpy(static_cast<void*>(&fill), value.data(), sizeof(T));
+    std::fill(array, array + n_elements, fill);
+}
+
+}  // namespace details
+
+template <typename T>
+inline void DataSet::readDenseFill(T* array) const {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "readDenseFill requires elements of a fixed size.");
+
+    const DataType mem_datatype = create_and_check_datatype<T>();
+    const size_t n_elements = getElementCount();
+    if (n_elements == 0) {
+        return;
+    }
+    if (mem_datatype.getSize() != sizeof(T)) {
+        throw DataTypeException("readDenseFill: the size of the memory datatype differs from T.");
+    }
+
+    auto dcpl = getCreatePropertyList();
+    if (H5Pget_layout(dcpl.getId()) != H5D_CHUNKED) {
+        read(array, mem_datatype);
+        return;
+    }
+
+    const auto dims = getDimensions();
+    const auto chunk_dims = Chunking(dcpl).getDimensions();
+    size_t n_chunks = 1;
+    for (size_t d = 0; d < dims.size(); ++d) {
+        n_chunks *= (dims[d] + chunk_dims[d] - 1) / chunk_dims[d];
+    }
+
+    const auto chunks = details::get_chunk_locations(*this, dims, chunk_dims);
+    if (chunks.size() == n_chunks) {
+        read(array, mem_datatype);
+        return;
+    }
+
+    details::fill_with_fill_value(dcpl, mem_datatype, array, n_elements);
+
+    // Read every chunk straight into its place in `array`.
+    const DataSpace mem_space(dims);
+    const DataSpace file_space = getSpace();
+    std::vector<size_t> count(dims.size());
+    for (const auto& chunk: chunks) {
+        const auto& offset = chunk.offset;
+        for (size_t d = 0; d < dims.size(); ++d) {
+            count[d] = std::min(size_t(chunk_dims[d]), dims[d] - offset[d]);
+        }
+        const HyperSlab slab(RegularHyperSlab(offset, count));
+        if (H5Dread(_hid,
+                    mem_datatype.getId(),
+                    slab.apply(mem_space).getId(),
+                    slab.apply(file_space).getId(),
+                    H5P_DEFAULT,
+                    static_cast<void*>(array)) < 0) {
+            HDF5ErrMapper::ToException<DataSetException>("Error during HDF5 Read.");
+        }
+    }
+}
+
 }  // namespace HighFive
@@ -8,10 +8,21 @@
  */
 #pragma once
 
+#include <atomic>
+#include <fstream>
+#include <set>
 #include <string>
+#include <vector>
 
 #include <H5Fpublic.h>
+#include <H5Lpublic.h>
+#include <H5Opublic.h>
 
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/stat.h>
+#endif
+
+#include "../H5Timeline.hpp"
 #include "../H5Utility.hpp"
 #include "H5Utils.hpp"
 
@@ -35,8 +46,131 @@ inline unsigned convert_open_flag(unsigned openFlags) {
         res_open |= H5F_ACC_EXCL;
     return res_open;
 }
+
+// The family driver requires a `printf`-style conversion of an unsigned
+// integer, e.g. `%d`, `%u` or `%05d`, in the file name. Otherwise, all members
+// would have the same name. `%%` is a literal percent sign.
+inline bool has_family_pattern(const std::string& filename) {
+    size_t i = filename.find('%');
+    while (i != std::string::npos) {
+        if (i + 1 < filename.size() && filename[i + 1] == '%') {
+            i = filename.find('%', i + 2);
+            continue;
+        }
+
+        // Flags, width and precision.
+        size_t j = filename.find_first_not_of("-+ #0", i + 1);
+        j = j == std::string::npos ? j : filename.find_first_not_of("0123456789", j);
+        if (j != std::string::npos && filename[j] == '.') {
+            j = filename.find_first_not_of("0123456789", j + 1);
+        }
+        if (j != std::string::npos && std::string("diuoxX").find(filename[j]) != std::string::npos) {
+            return true;
+        }
+        i = filename.find('%', i + 1);
+    }
+    return false;
+}
 }  // namespace
 
+namespace details {
+
+inline std::atomic<bool>& open_objects_check() {
+#ifdef HIGHFIVE_CHECK_OPEN_OBJECTS
+    static std::atomic<bool> enabled{true};
+#else
+    static std::atomic<bool> enabled{false};
+#endif
+    return enabled;
+}
+
+inline size_t count_open_objects(hid_t file_id, unsigned types) {
+    const ssize_t count = H5Fget_obj_count(file_id, types);
+    if (count < 0) {
+        HDF5ErrMapper::ToException<FileException>("Unable to count the open objects");
+    }
+    return static_cast<size_t>(count);
+}
+
+inline std::vector<OpenObject> get_open_objects(hid_t file_id) {
+    const unsigned types = H5F_OBJ_DATASET | H5F_OBJ_GROUP | H5F_OBJ_DATATYPE | H5F_OBJ_ATTR;
+    std::vector<hid_t> ids(count_open_objects(file_id, types));
+    if (!ids.empty() && H5Fget_obj_ids(file_id, types, ids.size(), ids.data()) < 0) {
+        HDF5ErrMapper::ToException<FileException>("Unable to list the open objects");
+    }
+
+    std::vector<OpenObject> objects;
+    objects.reserve(ids.size());
+    for (auto id: ids) {
+        auto path = get_name(
+            [id](char* buffer, size_t length) { return H5Iget_name(id, buffer, length); });
+        objects.push_back({_convert_object_type(H5Iget_type(id)), std::move(path)});
+    }
+    return objects;
+}
+
+inline void warn_open_objects(const std::string& filename,
+                              const std::vector<OpenObject>& objects) {
+    std::string message = "Closing the file " + filename + " while " +
+                          std::to_string(objects.size()) + " of its objects are open:";
+    for (const auto& object: objects) {
+        message += " " + (object.path.empty() ? std::string("<anonymous>") : object.path);
+    }
+    HIGHFIVE_LOG_WARN(message);
+}
+
+// Collects the names of the hard links, see `H5Lvisit`.
+template <typename InfoType>
+inline herr_t collect_hard_links(hid_t /*id*/,
+                                 const char* name,
+                                 const InfoType* info,
+                                 void* op_data) {
+    try {
+        if (info->type == H5L_TYPE_HARD) {
+            static_cast<std::vector<std::string>*>(op_data)->emplace_back(name);
+        }
+        return 0;
+    } catch (...) {
+        return -1;
+    }
+}
+
+// The address of an object, to tell apart objects reached by several links.
+inline haddr_t get_object_address(hid_t hid) {
+#if (H5Oget_info_vers < 3)
+    H5O_info_t info;
+    if (H5Oget_info(hid, &info) < 0) {
+#else
+    H5O_info1_t info;
+    if (H5Oget_info1(hid, &info) < 0) {
+#endif
+        HDF5ErrMapper::ToException<ObjectException>("Unable to obtain info for object");
+    }
+    return info.addr;
+}
+
+// Do `a` and `b` name the same existing file? Elsewhere than on POSIX systems,
+// only equal paths are detected.
+inline bool is_same_file(const std::string& a, const std::string& b) {
+#if defined(__unix__) || defined(__APPLE__)
+    struct stat status_a, status_b;
+    return ::stat(a.c_str(), &status_a) == 0 && ::stat(b.c_str(), &status_b) == 0 &&
+           status_a.st_dev == status_b.st_dev && status_a.st_ino == status_b.st_ino;
+#else
+    return a == b;
+#endif
+}
+
+// Releasing the last handle of a file closes it, which is shown on the timeline.
+inline const char* timeline_close_span(hid_t hid) noexcept {
+    if (Timeline::isActive() && H5Iget_ref(hid) == 1) {
+        return "File::close";
+    }
+    return nullptr;
+}
+
+}  // namespace details
+
 inline File::File(const std::string& filename,
                   unsigned openFlags,
                   const FileAccessProps& fileAccessProps)
@@ -47,8 +181,15 @@ inline File::File(const std::string& filename,
                   unsigned openFlags,
                   const FileCreateProps& fileCreateProps,
                   const FileAccessProps& fileAccessProps) {
+    HIGHFIVE_TIMELINE_SPAN("File::open", filename);
     openFlags = convert_open_flag(openFlags);
 
+    if (fileAccessProps.getId() != H5P_DEFAULT &&
+        H5Pget_driver(fileAccessProps.getId()) == H5FD_FAMILY && !has_family_pattern(filename)) {
+        throw FileException("The family driver requires a pattern like '%d' in the file name, got " +
+                            filename);
+    }
+
     unsigned createMode = openFlags & (H5F_ACC_TRUNC | H5F_ACC_EXCL);
     unsigned openMode = openFlags & (H5F_ACC_RDWR | H5F_ACC_RDONLY);
     bool mustCreate = createMode > 0;
@@ -83,6 +224,131 @@ inline File::File(const std::string& filename,
     }
 }
 
+inline File::File(const File& other)
+    : Object(other)
+    , _filename(other._filename)
+    , _held_by_object(other._held_by_object) {}
+
+inline File::File(File&& other) noexcept
+    : Object(std::move(other))
+    , _filename(std::move(other._filename))
+    , _held_by_object(other._held_by_object) {}
+
+inline File& File::operator=(const File& other) {
+    if (this != &other) {
+        _release();
+        Object::operator=(other);
+        _filename = other._filename;
+        _held_by_object = other._held_by_object;
+    }
+    return *this;
+}
+
+inline File& File::operator=(File&& other) noexcept {
+    if (this != &other) {
+        _release();
+        if (isValid()) {
+            HIGHFIVE_TIMELINE_SPAN(details::timeline_close_span(_hid));
+            if (H5Idec_ref(_hid) < 0) {
+                HIGHFIVE_LOG_ERROR("HighFive::File: reference counter decrease failure");
+            }
+        }
+        _hid = other._hid;
+        other._hid = H5I_INVALID_HID;
+        _filename = std::move(other._filename);
+        _held_by_object = other._held_by_object;
+    }
+    return *this;
+}
+
+inline File::~File() {
+    _release();
+    // Released here rather than by `~Object`, to show closing the file on the timeline.
+    if (isValid()) {
+        HIGHFIVE_TIMELINE_SPAN(details::timeline_close_span(_hid));
+        if (H5Idec_ref(_hid) < 0) {
+            HIGHFIVE_LOG_ERROR("HighFive::~File: reference counter decrease failure");
+        }
+        _hid = H5I_INVALID_HID;
+    }
+}
+
+// Only the check of `setOpenObjectsCheck` is done here; the handles of the
+// objects are left alone, HDF5 closes them if the file uses `H5F_CLOSE_STRONG`.
+inline void File::_release() noexcept {
+    if (_held_by_object || !details::open_objects_check().load(std::memory_order_relaxed) ||
+        !isValid()) {
+        return;
+    }
+
+    try {
+        // Objects don't hold a handle of the file, `getFile` opens a new one.
+        if (H5Iget_ref(_hid) != 1) {
+            return;
+        }
+
+        auto objects = details::get_open_objects(_hid);
+        if (!objects.empty()) {
+            details::warn_open_objects(getName(), objects);
+        }
+    } catch (...) {
+        // Releasing a handle must never throw.
+    }
+}
+
+inline void File::close() {
+    if (!isValid()) {
+        return;
+    }
+
+    _release();
+    const std::string name = getName();
+    HIGHFIVE_TIMELINE_SPAN(details::timeline_close_span(_hid));
+    if (H5Fclose(_hid) < 0) {
+        HDF5ErrMapper::ToException<FileException>("Unable to close the file " + name);
+    }
+    _hid = H5I_INVALID_HID;
+}
+
+inline File File::createFromTemplate(const std::string& template_path,
+                                     const std::string& filename,
+                                     const FileAccessProps& fileAccessProps) {
+    {
+        std::ifstream src(template_path, std::ios::binary);
+        if (!src) {
+            throw FileException("Unable to open template file " + template_path);
+        }
+        // Truncating the destination would destroy the template.
+        if (details::is_same_file(template_path, filename)) {
+            throw FileException("Unable to create " + filename + " from the template " +
+                                template_path + ", they're the same file");
+        }
+
+        std::ofstream dst(filename, std::ios::binary | std::ios::trunc);
+        dst << src.rdbuf();
+        if (!dst) {
+            throw FileException("Unable to copy template file " + template_path + " to " +
+                                filename);
+        }
+    }
+
+    return File(filename, File::ReadWrite, fileAccessProps);
+}
+
+inline File File::createFromTemplate(const std::vector<char>& image,
+                                     const std::string& filename,
+                                     const FileAccessProps& fileAccessProps) {
+    {
+        std::ofstream dst(filename, std::ios::binary | std::ios::trunc);
+        dst.write(image.data(), static_cast<std::streamsize>(image.size()));
+        if (!dst) {
+            throw FileException("Unable to write file image to " + filename);
+        }
+    }
+
+    return File(filename, File::ReadWrite, fileAccessProps);
+}
+
 inline const std::string& File::getName() const noexcept {
     if (_filename.empty()) {
         _filename = details::get_name(
@@ -122,6 +388,7 @@ inline hsize_t File::getFileSpacePageSize() const {
 #endif
 
 inline void File::flush() {
+    HIGHFIVE_TIMELINE_SPAN("File::flush");
     if (H5Fflush(_hid, H5F_SCOPE_GLOBAL) < 0) {
         HDF5ErrMapper::ToException<FileException>(std::string("Unable to flush file " + getName()));
     }
@@ -136,6 +403,26 @@ inline size_t File::getFileSize() const {
     return static_cast<size_t>(sizeValue);
 }
 
+inline std::vector<char> File::getFileImage() const {
+    // Pending metadata isn't part of the image.
+    if (H5Fflush(_hid, H5F_SCOPE_LOCAL) < 0) {
+        HDF5ErrMapper::ToException<FileException>(std::string("Unable to flush file " + getName()));
+    }
+
+    auto size = H5Fget_file_image(_hid, nullptr, 0);
+    if (size < 0) {
+        HDF5ErrMapper::ToException<FileException>(
+            std::string("Unable to retrieve the image of file " + getName()));
+    }
+
+    std::vector<char> image(static_cast<size_t>(size));
+    if (H5Fget_file_image(_hid, image.data(), image.size()) < 0) {
+        HDF5ErrMapper::ToException<FileException>(
+            std::string("Unable to retrieve the image of file " + getName()));
+    }
+    return image;
+}
+
 inline size_t File::getFreeSpace() const {
     hssize_t unusedSize = H5Fget_freespace(_hid);
     if (unusedSize < 0) {
@@ -145,4 +432,43 @@ inline size_t File::getFreeSpace() const {
     return static_cast<size_t>(unusedSize);
 }
 
+inline std::vector<OpenObject> File::getOpenObjects() const {
+    return details::get_open_objects(_hid);
+}
+
+inline std::vector<DataSetStorageReport> File::storageReport() const {
+    std::vector<std::string> names;
+    if (H5Lvisit(_hid,
+                 H5_INDEX_NAME,
+                 H5_ITER_INC,
+                 &details::collect_hard_links<H5L_info_t>,
+                 static_cast<void*>(&names)) < 0) {
+        HDF5ErrMapper::ToException<FileException>("Unable to list the objects of file " +
+                                                  getName());
+    }
+
+    std::set<haddr_t> visited;
+    std::vector<DataSetStorageReport> reports;
+    for (const auto& name: names) {
+        if (getObjectType(name) != ObjectType::Dataset) {
+            continue;
+        }
+        const auto dataset = getDataSet(name);
+        if (!visited.insert(details::get_object_address(dataset.getId())).second) {
+            continue;
+        }
+        reports.push_back(dataset.getStorageReport());
+        reports.back().path = "/" + name;
+    }
+    return reports;
+}
+
+inline void File::setOpenObjectsCheck(bool enabled) noexcept {
+    details::open_objects_check() = enabled;
+}
+
+inline bool File::hasOpenObjectsCheck() noexcept {
+    return details::open_objects_check();
+}
+
 }  // namespace HighFive
@@ -0,0 +1,342 @@
+/*
+ *  Copyright (c), 2023, Blue Brain Project - EPFL
+ *
+ *  Distributed under the Boost Software License, Version 1.0.
+ *    (See accompanying file LICENSE_1_0.txt or copy at
+ *          http://www.boost.org/LICENSE_1_0.txt)
+ *
+ */
+#pragma once
+
+#include <cstring>
+#include <utility>
+
+#include <H5Dpublic.h>
+#include <H5Fpublic.h>
+#include <H5Ipublic.h>
+#include <H5Spublic.h>
+#include <H5Tpublic.h>
+
+namespace HighFive {
+
+namespace details {
+
+struct IOTraceState {
+    std::atomic<bool> active{false};
+    std::mutex mutex;
+    std::ofstream out;
+    // The ids of the datasets, by name of the file and path.
+    std::map<std::pair<std::string, std::string>, uint32_t> ids;
+    // The ids of the datasets, by HDF5 id, to look up the names only once.
+    // Bounded, see `prune_trace_hids`.
+    std::unordered_map<hid_t, uint32_t> ids_by_hid;
+    std::chrono::steady_clock::time_point origin;
+};
+
+inline IOTraceState& get_io_trace_state() {
+    static IOTraceState state;
+    return state;
+}
+
+constexpr const char io_trace_magic[] = "HFIOTRC2";
+
+constexpr size_t max_traced_hids = 1024;
+
+// Keeps `ids_by_hid` from growing in processes which open and close datasets
+// over and over: once full, the closed datasets are dropped, or all of them if
+// most are still open. HDF5 doesn't reuse the ids of closed datasets, and the
+// names of the dropped ones are looked up again, `ids` still knows them.
+inline void prune_trace_hids(IOTraceState& state) {
+    auto& ids_by_hid = state.ids_by_hid;
+    if (ids_by_hid.size() < max_traced_hids) {
+        return;
+    }
+    for (auto it = ids_by_hid.begin(); it != ids_by_hid.end();) {
+        if (H5Iis_valid(it->first) > 0) {
+            ++it;
+        } else {
+            it = ids_by_hid.erase(it);
+        }
+    }
+    if (ids_by_hid.size() >= max_traced_hids / 2) {
+        ids_by_hid.clear();
+    }
+}
+
+template <typename T>
+inline void write_trace_value(std::ostream& out, const T& value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+inline void write_trace_string(std::ostream& out, const std::string& value) {
+    write_trace_value(out, static_cast<uint32_t>(value.size()));
+    out.write(value.data(), static_cast<std::streamsize>(value.size()));
+}
+
+// Either `H5Iget_name` or `H5Fget_name`.
+template <typename F>
+inline std::string get_trace_name(F get_name, hid_t id) {
+    std::string name;
+    ssize_t length = get_name(id, nullptr, 0);
+    if (length > 0) {
+        name.resize(static_cast<size_t>(length) + 1);
+        get_name(id, &name[0], name.size());
+        name.resize(static_cast<size_t>(length));
+    }
+    return name;
+}
+
+template <typename T>
+inline T read_trace_value(std::istream& in) {
+    T value;
+    if (!in.read(reinterpret_cast<char*>(&value), sizeof(T))) {
+        throw Exception("IOTrace: unexpected end of the trace.");
+    }
+    return value;
+}
+
+inline std::string read_trace_string(std::istream& in) {
+    std::string value(read_trace_value<uint32_t>(in), '\0');
+    if (!in.read(&value[0], static_cast<std::streamsize>(value.size()))) {
+        throw Exception("IOTrace: unexpected end of the trace.");
+    }
+    return value;
+}
+
+// The selection of an access, computed before taking the lock.
+struct IOTraceSelection {
+    IOTrace::SelectionType type = IOTrace::SelectionType::None;
+    uint64_t n_elements = 0;
+    std::vector<uint64_t> offset;
+    std::vector<uint64_t> count;
+};
+
+inline IOTraceSelection get_trace_selection(hid_t file_space_id) {
+    IOTraceSelection selection;
+    const int rank = H5Sget_simple_extent_ndims(file_space_id);
+    const size_t n_dims = static_cast<size_t>(std::max(rank, 0));
+    selection.offset.assign(n_dims, 0);
+    selection.count.assign(n_dims, 0);
+
+    const hssize_t n_elements = H5Sget_select_npoints(file_space_id);
+    if (n_elements <= 0) {
+        return selection;
+    }
+    selection.n_elements = static_cast<uint64_t>(n_elements);
+
+    std::vector<hsize_t> first(n_dims, 0), last(n_dims, 0);
+    if (n_dims > 0) {
+        H5Sget_select_bounds(file_space_id, first.data(), last.data());
+    }
+    uint64_t box_size = 1;
+    for (size_t d = 0; d < n_dims; ++d) {
+        selection.offset[d] = first[d];
+        selection.count[d] = last[d] - first[d] + 1;
+        box_size *= selection.count[d];
+    }
+
+    switch (H5Sget_select_type(file_space_id)) {
+    case H5S_SEL_ALL:
+        selection.type = IOTrace::SelectionType::All;
+        break;
+    case H5S_SEL_POINTS:
+        selection.type = IOTrace::SelectionType::Points;
+        break;
+    case H5S_SEL_HYPERSLABS:
+        selection.type = box_size == selection.n_elements ? IOTrace::SelectionType::Box
+                                                          : IOTrace::SelectionType::Hyperslab;
+        break;
+    default:
+        break;
+    }
+    return selection;
+}
+
+inline std::vector<uint64_t> read_trace_values(std::istream& in, size_t n) {
+    std::vector<uint64_t> values(n);
+    for (auto& v: values) {
+        v = read_trace_value<uint64_t>(in);
+    }
+    return values;
+}
+
+}  // namespace details
+
+inline void IOTrace::start(const std::string& filename) {
+    auto& state = details::get_io_trace_state();
+    std::lock_guard<std::mutex> lock(state.mutex);
+
+    state.active = false;
+    if (state.out.is_open()) {
+        state.out.close();
+    }
+    state.ids.clear();
+    state.ids_by_hid.clear();
+
+    state.out.open(filename, std::ios::binary | std::ios::trunc);
+    if (!state.out) {
+        throw Exception("IOTrace: unable to open " + filename);
+    }
+    state.out.write(details::io_trace_magic, 8);
+    state.origin = std::chrono::steady_clock::now();
+    state.active = true;
+}
+
+inline void IOTrace::stop() {
+    auto& state = details::get_io_trace_state();
+    std::lock_guard<std::mutex> lock(state.mutex);
+
+    state.active = false;
+    if (state.out.is_open()) {
+        state.out.close();
+    }
+    state.ids.clear();
+    state.ids_by_hid.clear();
+}
+
+inline bool IOTrace::isActive() noexcept {
+    return details::get_io_trace_state().active.load(std::memory_order_relaxed);
+}
+
+inline void IOTrace::record(Operation operation,
+                            hid_t dataset_id,
+                            hid_t file_space_id,
+                            std::chrono::steady_clock::time_point start,
+                            std::chrono::steady_clock::time_point stop) noexcept {
+    using details::write_trace_value;
+
+    auto& state = details::get_io_trace_state();
+    try {
+        const auto selection = details::get_trace_selection(file_space_id);
+
+        std::lock_guard<std::mutex> lock(state.mutex);
+        if (!state.active) {
+            return;
+        }
+        auto& out = state.out;
+
+        auto by_hid = state.ids_by_hid.find(dataset_id);
+        if (by_hid == state.ids_by_hid.end()) {
+            // Datasets of different files can have the same path.
+            auto key = std::make_pair(details::get_trace_name(H5Fget_name, dataset_id),
+                                      details::get_trace_name(H5Iget_name, dataset_id));
+
+            auto it = state.ids.find(key);
+            if (it == state.ids.end()) {
+                it = state.ids.emplace(key, static_cast<uint32_t>(state.ids.size())).first;
+
+                hid_t space_id = H5Dget_space(dataset_id);
+                int rank = H5Sget_simple_extent_ndims(space_id);
+                std::vector<hsize_t> dims(static_cast<size_t>(std::max(rank, 0)));
+                H5Sget_simple_extent_dims(space_id, dims.data(), nullptr);
+                H5Sclose(space_id);
+
+                hid_t type_id = H5Dget_type(dataset_id);
+                auto element_size = static_cast<uint32_t>(H5Tget_size(type_id));
+                H5Tclose(type_id);
+
+                out.put('D');
+                write_trace_value(out, it->second);
+                details::write_trace_string(out, key.first);
+                details::write_trace_string(out, key.second);
+                write_trace_value(out, element_size);
+                write_trace_value(out, static_cast<uint32_t>(dims.size()));
+                for (auto d: dims) {
+                    write_trace_value(out, static_cast<uint64_t>(d));
+                }
+            }
+            details::prune_trace_hids(state);
+            by_hid = state.ids_by_hid.emplace(dataset_id, it->second).first;
+        }
+
+        using std::chrono::duration_cast;
+        using std::chrono::nanoseconds;
+
+        out.put(static_cast<char>(operation));
+        write_trace_value(out, by_hid->second);
+        write_trace_value(out,
+                          static_cast<uint64_t>(
+                              duration_cast<nanoseconds>(start - state.origin).count()));
+        write_trace_value(out,
+                          static_cast<uint64_t>(duration_cast<nanoseconds>(stop - start).count()));
+        write_trace_value(out, selection.n_elements);
+        out.put(static_cast<char>(selection.type));
+        write_trace_value(out, static_cast<uint32_t>(selection.offset.size()));
+        for (auto v: selection.offset) {
+            write_trace_value(out, v);
+        }
+        for (auto v: selection.count) {
+            write_trace_value(out, v);
+        }
+    } catch (...) {
+        // Tracing must never break the traced application.
+    }
+}
+
+inline std::vector<IOTrace::Event> IOTrace::load(const std::string& filename) {
+    using details::read_trace_string;
+    using details::read_trace_value;
+    using details::read_trace_values;
+
+    std::ifstream in(filename, std::ios::binary);
+    char magic[8];
+    if (!in.read(magic, 8) || std::memcmp(magic, details::io_trace_magic, 8) != 0) {
+        throw Exception("IOTrace: " + filename + " isn't a trace.");
+    }
+
+    struct Dataset {
+        std::string file;
+        std::string name;
+        std::vector<size_t> dims;
+        size_t element_size;
+    };
+    std::map<uint32_t, Dataset> datasets;
+
+    std::vector<Event> events;
+    char kind;
+    while (in.get(kind)) {
+        const auto id = read_trace_value<uint32_t>(in);
+
+        if (kind == 'D') {
+            Dataset dataset;
+            dataset.file = read_trace_string(in);
+            dataset.name = read_trace_string(in);
+            dataset.element_size = read_trace_value<uint32_t>(in);
+            auto dims = read_trace_values(in, read_trace_value<uint32_t>(in));
+            dataset.dims.assign(dims.begin(), dims.end());
+            datasets[id] = std::move(dataset);
+            continue;
+        }
+
+        if (kind != static_cast<char>(Operation::Read) &&
+            kind != static_cast<char>(Operation::Write)) {
+            throw Exception("IOTrace: corrupted trace " + filename);
+        }
+
+        auto dataset = datasets.find(id);
+        if (dataset == datasets.end()) {
+            throw Exception("IOTrace: undefined dataset in trace " + filename);
+        }
+
+        Event event;
+        event.operation = static_cast<Operation>(kind);
+        event.file = dataset->second.file;
+        event.dataset = dataset->second.name;
+        event.dataset_dims = dataset->second.dims;
+        event.element_size = dataset->second.element_size;
+        event.start = read_trace_value<uint64_t>(in);
+        event.duration = read_trace_value<uint64_t>(in);
+        event.n_elements = read_trace_value<uint64_t>(in);
+        event.selection = static_cast<SelectionType>(read_trace_value<char>(in));
+        const auto n_dims = read_trace_value<uint32_t>(in);
+        auto offset = read_trace_values(in, n_dims);
+        auto count = read_trace_values(in, n_dims);
+        event.offset.assign(offset.begin(), offset.end());
+        event.count.assign(count.begin(), count.end());
+        events.push_back(std::move(event));
+    }
+
+    return events;
+}
+
+}  // namespace HighFive
@@ -352,9 +352,9 @@ struct inspector<FixedLenStringArray<N>> {
     }
 };
 
-template <typename T>
-struct inspector<std::vector<T>> {
-    using type = std::vector<T>;
+template <typename T, typename Allocator>
+struct inspector<std::vector<T, Allocator>> {
+    using type = std::vector<T, Allocator>;
     using value_type = unqualified_t<T>;
     using base_type = typename inspector<value_type>::base_type;
     using hdf5_type = typename inspector<value_type>::hdf5_type;
@@ -0,0 +1,655 @@
+/*
+ *  Copyright (c), 2023, Blue Brain Project - EPFL
+ *
+ *  Distributed under the Boost Software License, Version 1.0.
+ *    (See accompanying file LICENSE_1_0.txt or copy at
+ *          http://www.boost.org/LICENSE_1_0.txt)
+ *
+ */
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#if defined(__has_include)
+#if __has_include(<linux/io_uring.h>) && defined(__NR_io_uring_setup) && \
+    defined(__NR_io_uring_enter)
+#include <linux/io_uring.h>
+#define HIGHFIVE_HAS_IO_URING
+#endif
+#endif
+
+#include <H5Fpublic.h>
+#include <H5Ppublic.h>
+
+#include "../H5Exception.hpp"
+#include "../H5Utility.hpp"
+#include "H5VirtualFileDriver_misc.hpp"
+
+namespace HighFive {
+
+namespace details {
+namespace uring {
+
+// The properties stored in the file access property list.
+struct Config {
+    uint32_t queue_depth;
+    uint64_t block_size;
+};
+
+// Read or write `size` bytes at `offset` of the file from or to `buffer`.
+struct Request {
+    char* buffer;
+    uint64_t offset;
+    size_t size;
+};
+
+#ifdef HIGHFIVE_HAS_IO_URING
+
+// An io_uring instance, set up with the system calls rather than liburing.
+class Ring {
+  public:
+    // Returns null if io_uring can't be used.
+    static std::unique_ptr<Ring> create(unsigned entries) noexcept;
+    ~Ring();
+
+    Ring(const Ring&) = delete;
+    Ring& operator=(const Ring&) = delete;
+
+    // Performs all `requests` on `fd`, keeping up to `entries` of them in
+    // flight. Reads past the end of the file are filled with zeros. Returns
+    // false if any request failed.
+    bool run(int fd, bool write, std::vector<Request>& requests);
+
+  private:
+    Ring() = default;
+
+    int _fd = -1;
+    void* _sq_ring = MAP_FAILED;
+    size_t _sq_ring_size = 0;
+    void* _cq_ring = MAP_FAILED;
+    size_t _cq_ring_size = 0;
+    void* _sqes = MAP_FAILED;
+    size_t _sqes_size = 0;
+
+    unsigned _entries = 0;
+    unsigned* _sq_head = nullptr;
+    unsigned* _sq_tail = nullptr;
+    unsigned* _sq_mask = nullptr;
+    unsigned* _sq_array = nullptr;
+    unsigned* _cq_head = nullptr;
+    unsigned* _cq_tail = nullptr;
+    unsigned* _cq_mask = nullptr;
+    io_uring_cqe* _cqes = nullptr;
+};
+
+inline std::unique_ptr<Ring> Ring::create(unsigned entries) noexcept {
+    std::unique_ptr<Ring> ring(new (std::nothrow) Ring());
+    if (ring == nullptr) {
+        return nullptr;
+    }
+
+    io_uring_params params;
+    std::memset(&params, 0, sizeof(params));
+    ring->_fd = int(syscall(__NR_io_uring_setup, entries, &params));
+    if (ring->_fd < 0) {
+        return nullptr;
+    }
+
+    ring->_sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    ring->_cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    bool single_mmap = false;
+#ifdef IORING_FEAT_SINGLE_MMAP
+    // Since Linux 5.4, both rings are mapped at once.
+    single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+#endif
+    if (single_mmap) {
+        ring->_sq_ring_size = std::max(ring->_sq_ring_size, ring->_cq_ring_size);
+        ring->_cq_ring_size = 0;
+    }
+
+    ring->_sq_ring = mmap(nullptr,
+                          ring->_sq_ring_size,
+                          PROT_READ | PROT_WRITE,
+                          MAP_SHARED | MAP_POPULATE,
+                          ring->_fd,
+                          IORING_OFF_SQ_RING);
+    if (ring->_sq_ring == MAP_FAILED) {
+        return nullptr;
+    }
+    if (!single_mmap) {
+        ring->_cq_ring = mmap(nullptr,
+                              ring->_cq_ring_size,
+                              PROT_READ | PROT_WRITE,
+                              MAP_SHARED | MAP_POPULATE,
+                              ring->_fd,
+                              IORING_OFF_CQ_RING);
+        if (ring->_cq_ring == MAP_FAILED) {
+            return nullptr;
+        }
+    }
+    ring->_sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+    ring->_sqes = mmap(nullptr,
+                       ring->_sqes_size,
+                       PROT_READ | PROT_WRITE,
+                       MAP_SHARED | MAP_POPULATE,
+                       ring->_fd,
+                       IORING_OFF_SQES);
+    if (ring->_sqes == MAP_FAILED) {
+        return nullptr;
+    }
+
+    char* sq = static_cast<char*>(ring->_sq_ring);
+    char* cq = static_cast<char*>(single_mmap ? ring->_sq_ring : ring->_cq_ring);
+    ring->_entries = params.sq_entries;
+    ring->_sq_head = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+    ring->_sq_tail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+    ring->_sq_mask = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+    ring->_sq_array = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+    ring->_cq_head = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+    ring->_cq_tail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+    ring->_cq_mask = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+    ring->_cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+    return ring;
+}
+
+inline Ring::~Ring() {
+    if (_sqes != MAP_FAILED) {
+        munmap(_sqes, _sqes_size);
+    }
+    if (_cq_ring != MAP_FAILED) {
+        munmap(_cq_ring, _cq_ring_size);
+    }
+    if (_sq_ring != MAP_FAILED) {
+        munmap(_sq_ring, _sq_ring_size);
+    }
+    if (_fd >= 0) {
+        ::close(_fd);
+    }
+}
+
+inline bool Ring::run(int fd, bool write, std::vector<Request>& requests) {
+    // The requests still to be submitted, the first one last.
+    std::vector<size_t> pending(requests.size());
+    for (size_t i = 0; i < requests.size(); ++i) {
+        pending[i] = requests.size() - 1 - i;
+    }
+    std::vector<iovec> iovecs(requests.size());
+
+    // Entries are queued until the kernel consumes them, then in flight
+    // until they complete. Both refer to `iovecs` and the buffers, none may
+    // be left when returning.
+    bool ok = true;
+    size_t in_flight = 0;
+    unsigned tail = *_sq_tail;
+    while ((ok && !pending.empty()) || in_flight > 0 ||
+           tail != __atomic_load_n(_sq_head, __ATOMIC_ACQUIRE)) {
+        const unsigned head = __atomic_load_n(_sq_head, __ATOMIC_ACQUIRE);
+        while (ok && !pending.empty() && in_flight + (tail - head) < _entries) {
+            const size_t i = pending.back();
+            pending.pop_back();
+            iovecs[i].iov_base = requests[i].buffer;
+            iovecs[i].iov_len = requests[i].size;
+
+            const unsigned index = tail & *_sq_mask;
+            auto& sqe = static_cast<io_uring_sqe*>(_sqes)[index];
+            std::memset(&sqe, 0, sizeof(sqe));
+            sqe.opcode = write ? IORING_OP_WRITEV : IORING_OP_READV;
+            sqe.fd = fd;
+            sqe.off = requests[i].offset;
+            sqe.addr = uint64_t(reinterpret_cast<uintptr_t>(&iovecs[i]));
+            sqe.len = 1;
+            sqe.user_data = i;
+            _sq_array[index] = index;
+            ++tail;
+        }
+        __atomic_store_n(_sq_tail, tail, __ATOMIC_RELEASE);
+
+        const unsigned n_queued = tail - head;
+        const long status = syscall(
+            __NR_io_uring_enter, _fd, n_queued, 1u, IORING_ENTER_GETEVENTS, nullptr, 0);
+        const int error = errno;
+        in_flight += __atomic_load_n(_sq_head, __ATOMIC_ACQUIRE) - head;
+
+        if (status < 0 && error != EINTR && error != EAGAIN && error != EBUSY) {
+            // Only fails for invalid arguments. Without SQPOLL the kernel only
+            // reads the queue during `io_uring_enter`, the entries it didn't
+            // consume are withdrawn. Those in flight are still waited for.
+            ok = false;
+            tail = __atomic_load_n(_sq_head, __ATOMIC_ACQUIRE);
+            __atomic_store_n(_sq_tail, tail, __ATOMIC_RELEASE);
+            if (in_flight == 0) {
+                return false;
+            }
+        }
+
+        unsigned cq_head = *_cq_head;
+        const unsigned cq_tail = __atomic_load_n(_cq_tail, __ATOMIC_ACQUIRE);
+        for (; cq_head != cq_tail; ++cq_head) {
+            const auto& cqe = _cqes[cq_head & *_cq_mask];
+            const size_t i = size_t(cqe.user_data);
+            auto& request = requests[i];
+            --in_flight;
+
+            if (cqe.res == -EINTR || cqe.res == -EAGAIN) {
+                pending.push_back(i);
+            } else if (cqe.res < 0 || (cqe.res == 0 && write)) {
+                ok = false;
+            } else if (cqe.res == 0) {
+                // The end of the file.
+                std::memset(request.buffer, 0, request.size);
+            } else if (size_t(cqe.res) < request.size) {
+                request.buffer += cqe.res;
+                request.offset += uint64_t(cqe.res);
+                request.size -= size_t(cqe.res);
+                pending.push_back(i);
+            }
+        }
+        __atomic_store_n(_cq_head, cq_head, __ATOMIC_RELEASE);
+    }
+    return ok;
+}
+
+#else
+
+// Without the io_uring headers, the driver uses `pread` and `pwrite`.
+class Ring {
+  public:
+    static std::unique_ptr<Ring> create(unsigned) noexcept {
+        return nullptr;
+    }
+
+    bool run(int, bool, std::vector<Request>&) {
+        return false;
+    }
+};
+
+#endif
+
+// Like `pread` or `pwrite`, for all of `request`. Reads past the end of the
+// file are filled with zeros.
+inline bool transfer_fully(int fd, bool write, Request request) noexcept {
+    while (request.size > 0) {
+        const ssize_t n = write
+                              ? ::pwrite(fd, request.buffer, request.size, off_t(request.offset))
+                              : ::pread(fd, request.buffer, request.size, off_t(request.offset));
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n < 0 || (n == 0 && write)) {
+            return false;
+        }
+        if (n == 0) {
+            std::memset(request.buffer, 0, request.size);
+            return true;
+        }
+        request.buffer += n;
+        request.offset += uint64_t(n);
+        request.size -= size_t(n);
+    }
+    return true;
+}
+
+// The file driver. `pub` must be first, HDF5 only knows about it.
+struct DriverFile {
+    H5FD_t pub;
+    int fd;
+    haddr_t eoa;
+    haddr_t eof;
+    dev_t dev;
+    ino_t ino;
+    Config config;
+    // Null if io_uring can't be used.
+    std::unique_ptr<Ring> ring;
+    std::vector<Request> requests;
+};
+
+// Checks that the `n` ranges are within the allocated part of the file.
+inline bool check_ranges(const DriverFile& file,
+                         size_t n,
+                         const haddr_t* addrs,
+                         const size_t* sizes) noexcept {
+    for (size_t i = 0; i < n; ++i) {
+        if (addrs[i] == HADDR_UNDEF || addrs[i] + sizes[i] < addrs[i] ||
+            addrs[i] + sizes[i] > file.eoa) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Reads or writes the `n` ranges. They're split into blocks, which go through
+// the ring unless there's only one of them.
+inline bool transfer(DriverFile& file,
+                     bool write,
+                     size_t n,
+                     const haddr_t* addrs,
+                     const size_t* sizes,
+                     char* const* buffers) {
+    const size_t block_size = size_t(file.config.block_size);
+    auto& requests = file.requests;
+    requests.clear();
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t done = 0; done < sizes[i]; done += block_size) {
+            requests.push_back(
+                {buffers[i] + done, addrs[i] + done, std::min(block_size, sizes[i] - done)});
+        }
+    }
+
+    if (file.ring != nullptr && requests.size() > 1) {
+        return file.ring->run(file.fd, write, requests);
+    }
+    for (const auto& request: requests) {
+        if (!transfer_fully(file.fd, write, request)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+inline void update_eof(DriverFile& file, size_t n, const haddr_t* addrs, const size_t* sizes) {
+    for (size_t i = 0; i < n; ++i) {
+        file.eof = std::max(file.eof, addrs[i] + sizes[i]);
+    }
+}
+
+inline H5FD_t* open(const char* name, unsigned flags, hid_t fapl, haddr_t) noexcept {
+    try {
+        const auto* config = static_cast<const Config*>(H5Pget_driver_info(fapl));
+        if (config == nullptr) {
+            return nullptr;
+        }
+
+        int o_flags = (flags & H5F_ACC_RDWR) ? O_RDWR : O_RDONLY;
+        if (flags & H5F_ACC_TRUNC) {
+            o_flags |= O_TRUNC;
+        }
+        if (flags & H5F_ACC_CREAT) {
+            o_flags |= O_CREAT;
+        }
+        if (flags & H5F_ACC_EXCL) {
+            o_flags |= O_EXCL;
+        }
+
+        std::unique_ptr<DriverFile> file(new DriverFile());
+        file->fd = ::open(name, o_flags, 0666);
+        if (file->fd < 0) {
+            return nullptr;
+        }
+
+        struct stat status;
+        if (fstat(file->fd, &status) != 0) {
+            ::close(file->fd);
+            return nullptr;
+        }
+        file->dev = status.st_dev;
+        file->ino = status.st_ino;
+        file->eof = haddr_t(status.st_size);
+        file->config = *config;
+        file->ring = Ring::create(config->queue_depth);
+        return &file.release()->pub;
+    } catch (const std::exception& e) {
+        HIGHFIVE_LOG_ERROR(e.what());
+    } catch (...) {
+    }
+    return nullptr;
+}
+
+inline herr_t close(H5FD_t* _file) noexcept {
+    auto* file = reinterpret_cast<DriverFile*>(_file);
+    const int status = ::close(file->fd);
+    delete file;
+    return status == 0 ? 0 : -1;
+}
+
+inline int cmp(const H5FD_t* _a, const H5FD_t* _b) noexcept {
+    const auto* a = reinterpret_cast<const DriverFile*>(_a);
+    const auto* b = reinterpret_cast<const DriverFile*>(_b);
+    if (a->dev != b->dev) {
+        return a->dev < b->dev ? -1 : 1;
+    }
+    if (a->ino != b->ino) {
+        return a->ino < b->ino ? -1 : 1;
+    }
+    return 0;
+}
+
+inline herr_t query(const H5FD_t*, unsigned long* flags) noexcept {
+    if (flags != nullptr) {
+        *flags = H5FD_FEAT_AGGREGATE_METADATA | H5FD_FEAT_ACCUMULATE_METADATA |
+                 H5FD_FEAT_DATA_SIEVE | H5FD_FEAT_AGGREGATE_SMALLDATA |
+                 H5FD_FEAT_POSIX_COMPAT_HANDLE;
+    }
+    return 0;
+}
+
+inline herr_t read(
+    H5FD_t* _file, H5FD_mem_t, hid_t, haddr_t addr, size_t size, void* buffer) noexcept {
+    auto* file = reinterpret_cast<DriverFile*>(_file);
+    if (!check_ranges(*file, 1, &addr, &size)) {
+        return -1;
+    }
+
+    try {
+        char* dst = static_cast<char*>(buffer);
+        return transfer(*file, false, 1, &addr, &size, &dst) ? 0 : -1;
+    } catch (const std::exception& e) {
+        HIGHFIVE_LOG_ERROR(e.what());
+    } catch (...) {
+    }
+    return -1;
+}
+
+inline herr_t write(
+    H5FD_t* _file, H5FD_mem_t, hid_t, haddr_t addr, size_t size, const void* buffer) noexcept {
+    auto* file = reinterpret_cast<DriverFile*>(_file);
+    if (!check_ranges(*file, 1, &addr, &size)) {
+        return -1;
+    }
+
+    try {
+        // Writes only read from the buffer.
+        char* src = static_cast<char*>(const_cast<void*>(buffer));
+        if (!transfer(*file, true, 1, &addr, &size, &src)) {
+            return -1;
+        }
+        update_eof(*file, 1, &addr, &size);
+        return 0;
+    } catch (const std::exception& e) {
+        HIGHFIVE_LOG_ERROR(e.what());
+    } catch (...) {
+    }
+    return -1;
+}
+
+#if H5_VERSION_GE(1, 14, 0)
+// Reads or writes the vector of `count` ranges. A size of 0 means that the
+// remaining ranges have the size of the previous one.
+inline herr_t transfer_vector(H5FD_t* _file,
+                              bool write,
+                              uint32_t count,
+                              const haddr_t* addrs,
+                              const size_t* sizes,
+                              char* const* buffers) noexcept {
+    auto* file = reinterpret_cast<DriverFile*>(_file);
+    try {
+        std::vector<size_t> all_sizes(count);
+        bool repeat = false;
+        size_t size = 0;
+        for (uint32_t i = 0; i < count; ++i) {
+            repeat = repeat || sizes[i] == 0;
+            if (!repeat) {
+                size = sizes[i];
+            }
+            all_sizes[i] = size;
+        }
+
+        if (!check_ranges(*file, count, addrs, all_sizes.data()) ||
+            !transfer(*file, write, count, addrs, all_sizes.data(), buffers)) {
+            return -1;
+        }
+        if (write) {
+            update_eof(*file, count, addrs, all_sizes.data());
+        }
+        return 0;
+    } catch (const std::exception& e) {
+        HIGHFIVE_LOG_ERROR(e.what());
+    } catch (...) {
+    }
+    return -1;
+}
+
+inline herr_t read_vector(H5FD_t* file,
+                          hid_t,
+                          uint32_t count,
+                          H5FD_mem_t[],
+                          haddr_t addrs[],
+                          size_t sizes[],
+                          void* buffers[]) noexcept {
+    try {
+        std::vector<char*> dst(count);
+        for (uint32_t i = 0; i < count; ++i) {
+            dst[i] = static_cast<char*>(buffers[i]);
+        }
+        return transfer_vector(file, false, count, addrs, sizes, dst.data());
+    } catch (...) {
+    }
+    return -1;
+}
+
+inline herr_t write_vector(H5FD_t* file,
+                           hid_t,
+                           uint32_t count,
+                           H5FD_mem_t[],
+                           haddr_t addrs[],
+                           size_t sizes[],
+                           const void* buffers[]) noexcept {
+    try {
+        // Writes only read from the buffers.
+        std::vector<char*> src(count);
+        for (uint32_t i = 0; i < count; ++i) {
+            src[i] = static_cast<char*>(const_cast<void*>(buffers[i]));
+        }
+        return transfer_vector(file, true, count, addrs, sizes, src.data());
+    } catch (...) {
+    }
+    return -1;
+}
+#endif
+
+inline herr_t truncate(H5FD_t* _file, hid_t, hbool_t) noexcept {
+    auto* file = reinterpret_cast<DriverFile*>(_file);
+    if (file->eoa != file->eof) {
+        if (ftruncate(file->fd, off_t(file->eoa)) != 0) {
+            return -1;
+        }
+        file->eof = file->eoa;
+    }
+    return 0;
+}
+
+inline herr_t lock(H5FD_t* _file, hbool_t rw) noexcept {
+    auto* file = reinterpret_cast<DriverFile*>(_file);
+    // Like sec2, file systems without locks are accepted.
+    if (flock(file->fd, (rw ? LOCK_EX : LOCK_SH) | LOCK_NB) != 0 && errno != ENOSYS) {
+        return -1;
+    }
+    return 0;
+}
+
+inline herr_t unlock(H5FD_t* _file) noexcept {
+    auto* file = reinterpret_cast<DriverFile*>(_file);
+    if (flock(file->fd, LOCK_UN) != 0 && errno != ENOSYS) {
+        return -1;
+    }
+    return 0;
+}
+
+inline H5FD_class_t make_driver_class() {
+    // From the range reserved for drivers which aren't registered with The HDF Group.
+    auto cls = vfd::make_class<DriverFile>("highfive_io_uring", 510);
+    cls.open = open;
+    cls.close = close;
+    cls.cmp = cmp;
+    cls.query = query;
+    cls.read = read;
+    cls.write = write;
+#if H5_VERSION_GE(1, 14, 0)
+    cls.read_vector = read_vector;
+    cls.write_vector = write_vector;
+#endif
+    cls.truncate = truncate;
+    cls.lock = lock;
+    cls.unlock = unlock;
+    return cls;
+}
+
+inline hid_t driver_id() {
+    return vfd::driver_id<make_driver_class>();
+}
+
+}  // namespace uring
+}  // namespace details
+
+inline IoUringDriver::IoUringDriver(unsigned queue_depth, size_t block_size)
+    : _queue_depth(queue_depth)
+    , _block_size(block_size) {
+    if (queue_depth == 0 || queue_depth > 4096) {
+        throw PropertyException("IoUringDriver: the queue depth must be between 1 and 4096.");
+    }
+    if (block_size == 0) {
+        throw PropertyException("IoUringDriver: the block size must be positive.");
+    }
+}
+
+inline IoUringDriver::IoUringDriver(const FileAccessProps& fapl) {
+    if (H5Pget_driver(fapl.getId()) != details::uring::driver_id()) {
+        throw PropertyException("The file access properties don't use an IoUringDriver.");
+    }
+    const auto* config =
+        static_cast<const details::uring::Config*>(H5Pget_driver_info(fapl.getId()));
+    if (config == nullptr) {
+        HDF5ErrMapper::ToException<PropertyException>(
+            "Unable to access the IoUringDriver properties");
+    }
+    _queue_depth = config->queue_depth;
+    _block_size = size_t(config->block_size);
+}
+
+inline unsigned IoUringDriver::getQueueDepth() const noexcept {
+    return _queue_depth;
+}
+
+inline size_t IoUringDriver::getBlockSize() const noexcept {
+    return _block_size;
+}
+
+inline bool IoUringDriver::isAvailable() {
+    static const bool available = details::uring::Ring::create(1) != nullptr;
+    return available;
+}
+
+inline void IoUringDriver::apply(const hid_t list) const {
+    details::uring::Config config;
+    std::memset(&config, 0, sizeof(config));
+    config.queue_depth = _queue_depth;
+    config.block_size = _block_size;
+    if (H5Pset_driver(list, details::uring::driver_id(), &config) < 0) {
+        HDF5ErrMapper::ToException<PropertyException>("Unable to set the IoUringDriver");
+    }
+}
+
+}  // namespace HighFive
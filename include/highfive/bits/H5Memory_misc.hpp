@@ -0,0 +1,101 @@
+/*
+ *  Copyright (c), 2023, Blue Brain Project - EPFL
+ *
+ *  Distributed under the Boost Software License, Version 1.0.
+ *    (See accompanying file LICENSE_1_0.txt or copy at
+ *          http://www.boost.org/LICENSE_1_0.txt)
+ *
+ */
+#pragma once
+
+#include <H5Fpublic.h>
+#include <H5Ppublic.h>
+#include <H5public.h>
+
+#include "H5Converter_misc.hpp"
+
+namespace HighFive {
+
+namespace details {
+
+inline MemoryReport::FileMemory file_memory(hid_t file_id) {
+    MemoryReport::FileMemory memory;
+    memory.name = get_name(
+        [file_id](char* buffer, size_t length) { return H5Fget_name(file_id, buffer, length); });
+
+    size_t min_clean_size = 0;
+    int n_entries = 0;
+    if (H5Fget_mdc_size(file_id,
+                        &memory.metadata_cache_max_size,
+                        &min_clean_size,
+                        &memory.metadata_cache_size,
+                        &n_entries) < 0) {
+        HDF5ErrMapper::ToException<FileException>(
+            "Unable to retrieve the metadata cache size of file " + memory.name);
+    }
+    memory.metadata_cache_entries = static_cast<size_t>(n_entries);
+
+    hid_t fapl = H5Fget_access_plist(file_id);
+    if (fapl < 0) {
+        HDF5ErrMapper::ToException<FileException>(
+            "Unable to retrieve the access properties of file " + memory.name);
+    }
+    int mdc_n_elements = 0;
+    double w0 = 0.0;
+    const herr_t status = H5Pget_cache(
+        fapl, &mdc_n_elements, &memory.chunk_cache_slots, &memory.chunk_cache_size, &w0);
+    H5Pclose(fapl);
+    if (status < 0) {
+        HDF5ErrMapper::ToException<FileException>(
+            "Unable to retrieve the chunk cache of file " + memory.name);
+    }
+
+    memory.open_datasets = count_open_objects(file_id, H5F_OBJ_DATASET);
+    memory.open_groups = count_open_objects(file_id, H5F_OBJ_GROUP);
+    memory.open_datatypes = count_open_objects(file_id, H5F_OBJ_DATATYPE);
+    memory.open_attributes = count_open_objects(file_id, H5F_OBJ_ATTR);
+    return memory;
+}
+
+}  // namespace details
+
+inline MemoryReport memoryReport() {
+    MemoryReport report;
+
+#if H5_VERSION_GE(1, 10, 7)
+    if (H5get_free_list_sizes(&report.free_list_regular_size,
+                              &report.free_list_array_size,
+                              &report.free_list_block_size,
+                              &report.free_list_factory_size) < 0) {
+        HDF5ErrMapper::ToException<Exception>("Unable to retrieve the free list sizes");
+    }
+#endif
+
+    const size_t n_files = details::count_open_objects(H5F_OBJ_ALL, H5F_OBJ_FILE);
+    std::vector<hid_t> file_ids(n_files);
+    if (n_files > 0 && H5Fget_obj_ids(H5F_OBJ_ALL, H5F_OBJ_FILE, n_files, file_ids.data()) < 0) {
+        HDF5ErrMapper::ToException<FileException>("Unable to list the open files");
+    }
+    report.files.reserve(n_files);
+    for (auto file_id: file_ids) {
+        report.files.push_back(details::file_memory(file_id));
+    }
+
+    const auto& counters = details::get_staging_counters();
+    report.staging_size = counters.size.load();
+    report.staging_peak_size = counters.peak_size.load();
+    return report;
+}
+
+inline void setFreeListLimits(const FreeListLimits& limits) {
+    if (H5set_free_list_limits(limits.regular_global,
+                               limits.regular_list,
+                               limits.array_global,
+                               limits.array_list,
+                               limits.block_global,
+                               limits.block_list) < 0) {
+        HDF5ErrMapper::ToException<Exception>("Unable to set the free list limits");
+    }
+}
+
+}  // namespace HighFive
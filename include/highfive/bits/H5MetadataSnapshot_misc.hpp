@@ -0,0 +1,387 @@
+/*
+ *  Copyright (c), 2023, Blue Brain Project - EPFL
+ *
+ *  Distributed under the Boost Software License, Version 1.0.
+ *    (See accompanying file LICENSE_1_0.txt or copy at
+ *          http://www.boost.org/LICENSE_1_0.txt)
+ *
+ */
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <exception>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <H5Apublic.h>
+#include <H5Dpublic.h>
+#include <H5Gpublic.h>
+#include <H5Lpublic.h>
+#include <H5Opublic.h>
+#include <H5Ppublic.h>
+#include <H5FDcore.h>
+
+namespace HighFive {
+
+namespace details {
+
+// File access properties of an in-memory file, optionally opened from an image.
+struct MetadataSnapshotAccess {
+    explicit MetadataSnapshotAccess(const std::vector<char>* image_ = nullptr)
+        : image(image_) {}
+
+    const std::vector<char>* image;
+
+    void apply(hid_t fapl) const {
+        if (H5Pset_fapl_core(fapl, 64 * 1024, 0) < 0) {
+            HDF5ErrMapper::ToException<PropertyException>("Unable to set the core driver");
+        }
+        if (image != nullptr &&
+            H5Pset_file_image(fapl, const_cast<char*>(image->data()), image->size()) < 0) {
+            HDF5ErrMapper::ToException<PropertyException>("Unable to set the file image");
+        }
+    }
+};
+
+// The core driver identifies files by name, hence every snapshot needs its own.
+inline std::string metadata_snapshot_name() {
+    static std::atomic<unsigned long> counter{0};
+    return "highfive-metadata-snapshot-" + std::to_string(counter++) + ".h5";
+}
+
+template <typename Exception>
+inline Object checked_object(hid_t hid, const std::string& msg) {
+    if (hid < 0) {
+        HDF5ErrMapper::ToException<Exception>(msg);
+    }
+    return detail::make_object(hid);
+}
+
+#if (H5Oget_info_vers < 3)
+using snapshot_object_info = H5O_info_t;
+#else
+using snapshot_object_info = H5O_info1_t;
+#endif
+
+struct MetadataCopy {
+    // Access properties with collective metadata reads disabled, such that
+    // a single rank can traverse a file opened with `MPIOCollectiveMetadataRead`.
+    Object lapl;
+    Object aapl;
+    hid_t dst_file;
+    // Paths in the snapshot of the objects copied so far, by address.
+    std::map<haddr_t, std::string> copied;
+};
+
+inline snapshot_object_info get_object_info(const MetadataCopy& ctx, hid_t obj) {
+    snapshot_object_info info;
+#if (H5Oget_info_vers < 3)
+    if (H5Oget_info_by_name(obj, ".", &info, ctx.lapl.getId()) < 0) {
+#else
+    if (H5Oget_info_by_name1(obj, ".", &info, ctx.lapl.getId()) < 0) {
+#endif
+        HDF5ErrMapper::ToException<ObjectException>("Unable to obtain info for object");
+    }
+    return info;
+}
+
+inline void copy_attributes(const MetadataCopy& ctx, hid_t src, hid_t dst, hsize_t n_attrs) {
+    for (hsize_t i = 0; i < n_attrs; ++i) {
+        auto attr = checked_object<AttributeException>(
+            H5Aopen_by_idx(
+                src, ".", H5_INDEX_NAME, H5_ITER_INC, i, ctx.aapl.getId(), ctx.lapl.getId()),
+            "Unable to open attribute");
+        auto name = get_name([&](char* buffer, size_t length) {
+            return H5Aget_name(attr.getId(), length, buffer);
+        });
+
+        // A transient copy, in case the attribute uses a committed datatype.
+        auto file_type = checked_object<DataTypeException>(H5Aget_type(attr.getId()),
+                                                           "Unable to get datatype of " + name);
+        auto type = checked_object<DataTypeException>(H5Tcopy(file_type.getId()),
+                                                      "Unable to copy datatype of " + name);
+        auto space = checked_object<DataSpaceException>(H5Aget_space(attr.getId()),
+                                                        "Unable to get dataspace of " + name);
+
+        auto copy = checked_object<AttributeException>(
+            H5Acreate2(dst, name.c_str(), type.getId(), space.getId(), H5P_DEFAULT, H5P_DEFAULT),
+            "Unable to create attribute " + name);
+
+        auto n_elements = H5Sget_simple_extent_npoints(space.getId());
+        if (n_elements <= 0) {
+            continue;
+        }
+
+        std::vector<char> buffer(static_cast<size_t>(n_elements) * H5Tget_size(type.getId()));
+        if (H5Aread(attr.getId(), type.getId(), buffer.data()) < 0) {
+            HDF5ErrMapper::ToException<AttributeException>("Unable to read attribute " + name);
+        }
+        auto status = H5Awrite(copy.getId(), type.getId(), buffer.data());
+#if H5_VERSION_GE(1, 12, 0)
+        (void) H5Treclaim(type.getId(), space.getId(), H5P_DEFAULT, buffer.data());
+#else
+        (void) H5Dvlen_reclaim(type.getId(), space.getId(), H5P_DEFAULT, buffer.data());
+#endif
+        if (status < 0) {
+            HDF5ErrMapper::ToException<AttributeException>("Unable to write attribute " + name);
+        }
+    }
+}
+
+// Creates a dataset of the same type and shape, without allocating any storage.
+inline Object copy_dataset(hid_t src, hid_t dst, const std::string& name) {
+    auto file_type = checked_object<DataTypeException>(H5Dget_type(src),
+                                                       "Unable to get datatype of " + name);
+    auto type = checked_object<DataTypeException>(H5Tcopy(file_type.getId()),
+                                                  "Unable to copy datatype of " + name);
+    auto space = checked_object<DataSpaceException>(H5Dget_space(src),
+                                                    "Unable to get dataspace of " + name);
+    auto src_dcpl = checked_object<PropertyException>(H5Dget_create_plist(src),
+                                                      "Unable to get properties of " + name);
+    auto dcpl = checked_object<PropertyException>(H5Pcreate(H5P_DATASET_CREATE),
+                                                  "Unable to create property list");
+
+    const int n_dims = H5Sget_simple_extent_ndims(space.getId());
+    std::vector<hsize_t> dims(static_cast<size_t>(std::max(n_dims, 0)));
+    std::vector<hsize_t> max_dims(dims.size());
+    H5Sget_simple_extent_dims(space.getId(), dims.data(), max_dims.data());
+
+    // Chunking is only needed for extensible datasets, and to report the
+    // same chunk shape.
+    std::vector<hsize_t> chunk(dims.size(), 1);
+    const bool chunked = H5Pget_layout(src_dcpl.getId()) == H5D_CHUNKED;
+    if (chunked && H5Pget_chunk(src_dcpl.getId(), n_dims, chunk.data()) < 0) {
+        HDF5ErrMapper::ToException<PropertyException>("Unable to get chunk size of " + name);
+    }
+    if ((chunked || dims != max_dims) &&
+        H5Pset_chunk(dcpl.getId(), n_dims, chunk.data()) < 0) {
+        HDF5ErrMapper::ToException<PropertyException>("Unable to set chunk size of " + name);
+    }
+
+    H5D_fill_value_t fill_status;
+    if (H5Pfill_value_defined(src_dcpl.getId(), &fill_status) >= 0 &&
+        fill_status == H5D_FILL_VALUE_USER_DEFINED && H5Tis_variable_str(type.getId()) == 0 &&
+        H5Tdetect_class(type.getId(), H5T_VLEN) == 0) {
+        std::vector<char> fill_value(H5Tget_size(type.getId()));
+        if (H5Pget_fill_value(src_dcpl.getId(), type.getId(), fill_value.data()) < 0 ||
+            H5Pset_fill_value(dcpl.getId(), type.getId(), fill_value.data()) < 0) {
+            HDF5ErrMapper::ToException<PropertyException>("Unable to copy fill value of " +
+                                                          name);
+        }
+    }
+
+    return checked_object<DataSetException>(H5Dcreate2(dst,
+                                                       name.c_str(),
+                                                       type.getId(),
+                                                       space.getId(),
+                                                       H5P_DEFAULT,
+                                                       dcpl.getId(),
+                                                       H5P_DEFAULT),
+                                            "Unable to create dataset " + name);
+}
+
+inline void copy_group(MetadataCopy& ctx, hid_t src, hid_t dst, const std::string& path);
+
+inline void copy_object(MetadataCopy& ctx,
+                        hid_t src_parent,
+                        hid_t dst_parent,
+                        const std::string& name,
+                        const std::string& path) {
+    auto src = checked_object<GroupException>(H5Oopen(src_parent,
+                                                      name.c_str(),
+                                                      ctx.lapl.getId()),
+                                              "Unable to open object " + path);
+    auto info = get_object_info(ctx, src.getId());
+
+    auto it = ctx.copied.find(info.addr);
+    if (it != ctx.copied.end()) {
+        if (H5Lcreate_hard(
+                ctx.dst_file, it->second.c_str(), dst_parent, name.c_str(), H5P_DEFAULT, H5P_DEFAULT) <
+            0) {
+            HDF5ErrMapper::ToException<GroupException>("Unable to create hard link " + path);
+        }
+        return;
+    }
+    ctx.copied[info.addr] = path;
+
+    switch (info.type) {
+    case H5O_TYPE_GROUP: {
+        auto dst = checked_object<GroupException>(
+            H5Gcreate2(dst_parent, name.c_str(), H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT),
+            "Unable to create group " + path);
+        copy_attributes(ctx, src.getId(), dst.getId(), info.num_attrs);
+        copy_group(ctx, src.getId(), dst.getId(), path);
+        break;
+    }
+    case H5O_TYPE_DATASET: {
+        auto dst = copy_dataset(src.getId(), dst_parent, name);
+        copy_attributes(ctx, src.getId(), dst.getId(), info.num_attrs);
+        break;
+    }
+    case H5O_TYPE_NAMED_DATATYPE: {
+        auto dst = checked_object<DataTypeException>(H5Tcopy(src.getId()),
+                                                     "Unable to copy datatype " + path);
+        if (H5Tcommit2(dst_parent,
+                       name.c_str(),
+                       dst.getId(),
+                       H5P_DEFAULT,
+                       H5P_DEFAULT,
+                       H5P_DEFAULT) < 0) {
+            HDF5ErrMapper::ToException<DataTypeException>("Unable to commit datatype " + path);
+        }
+        copy_attributes(ctx, src.getId(), dst.getId(), info.num_attrs);
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+inline void copy_group(MetadataCopy& ctx, hid_t src, hid_t dst, const std::string& path) {
+    const hid_t lapl = ctx.lapl.getId();
+
+    H5G_info_t group_info;
+    if (H5Gget_info_by_name(src, ".", &group_info, lapl) < 0) {
+        HDF5ErrMapper::ToException<GroupException>("Unable to obtain info for group " + path);
+    }
+
+    for (hsize_t i = 0; i < group_info.nlinks; ++i) {
+        auto name = get_name([&](char* buffer, size_t length) {
+            return H5Lget_name_by_idx(
+                src, ".", H5_INDEX_NAME, H5_ITER_INC, i, buffer, length, lapl);
+        });
+        auto link_path = (path == "/" ? path : path + "/") + name;
+
+        H5L_info_t link_info;
+        if (H5Lget_info(src, name.c_str(), &link_info, lapl) < 0) {
+            HDF5ErrMapper::ToException<GroupException>("Unable to obtain info for link " +
+                                                       link_path);
+        }
+
+        if (link_info.type == H5L_TYPE_HARD) {
+            copy_object(ctx, src, dst, name, link_path);
+            continue;
+        }
+
+        std::vector<char> value(link_info.u.val_size);
+        if (H5Lget_val(src, name.c_str(), value.data(), value.size(), lapl) < 0) {
+            HDF5ErrMapper::ToException<GroupException>("Unable to get value of link " +
+                                                       link_path);
+        }
+
+        herr_t status = 0;
+        if (link_info.type == H5L_TYPE_SOFT) {
+            status = H5Lcreate_soft(value.data(), dst, name.c_str(), H5P_DEFAULT, H5P_DEFAULT);
+        } else if (link_info.type == H5L_TYPE_EXTERNAL) {
+            const char* file_name = nullptr;
+            const char* obj_path = nullptr;
+            status = H5Lunpack_elink_val(value.data(), value.size(), nullptr, &file_name, &obj_path);
+            if (status >= 0) {
+                status = H5Lcreate_external(
+                    file_name, obj_path, dst, name.c_str(), H5P_DEFAULT, H5P_DEFAULT);
+            }
+        }
+        if (status < 0) {
+            HDF5ErrMapper::ToException<GroupException>("Unable to create link " + link_path);
+        }
+    }
+}
+
+inline Object create_metadata_access_plist(hid_t cls) {
+    auto plist = checked_object<PropertyException>(H5Pcreate(cls),
+                                                   "Unable to create property list");
+    if (H5Pset_all_coll_metadata_ops(plist.getId(), false) < 0) {
+        HDF5ErrMapper::ToException<PropertyException>(
+            "Unable to disable collective metadata reads");
+    }
+    return plist;
+}
+
+// Copies the structure of `src_file` into an in-memory file and returns its image.
+inline std::vector<char> create_metadata_image(hid_t src_file) {
+    MetadataCopy ctx{create_metadata_access_plist(H5P_LINK_ACCESS),
+                     create_metadata_access_plist(H5P_ATTRIBUTE_ACCESS),
+                     H5I_INVALID_HID,
+                     {}};
+
+    FileAccessProps fapl;
+    fapl.add(MetadataSnapshotAccess());
+    File snapshot(metadata_snapshot_name(), File::Truncate, fapl);
+    ctx.dst_file = snapshot.getId();
+
+    auto src = checked_object<GroupException>(H5Oopen(src_file, "/", ctx.lapl.getId()),
+                                              "Unable to open root group");
+    auto dst = checked_object<GroupException>(H5Oopen(ctx.dst_file, "/", H5P_DEFAULT),
+                                              "Unable to open root group");
+    auto info = get_object_info(ctx, src.getId());
+    ctx.copied[info.addr] = "/";
+
+    copy_attributes(ctx, src.getId(), dst.getId(), info.num_attrs);
+    copy_group(ctx, src.getId(), dst.getId(), "/");
+
+    return snapshot.getFileImage();
+}
+
+// Creates the image on `root` with `create_image`, broadcasts it and opens it on all ranks.
+template <typename F>
+inline File broadcast_metadata_image(F create_image, MPI_Comm comm, int root) {
+    int mpi_rank = 0;
+    MPI_Comm_rank(comm, &mpi_rank);
+
+    std::vector<char> image;
+    std::exception_ptr error;
+    unsigned long long size = 0;
+    if (mpi_rank == root) {
+        try {
+            image = create_image();
+            size = image.size();
+        } catch (...) {
+            error = std::current_exception();
+            size = ULLONG_MAX;
+        }
+    }
+
+    MPI_Bcast(&size, 1, MPI_UNSIGNED_LONG_LONG, root, comm);
+    if (size == ULLONG_MAX) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+        throw FileException("Unable to create the metadata snapshot on rank " +
+                            std::to_string(root));
+    }
+
+    image.resize(size);
+    for (size_t offset = 0; offset < image.size(); offset += INT_MAX) {
+        auto count = std::min(image.size() - offset, static_cast<size_t>(INT_MAX));
+        MPI_Bcast(image.data() + offset, static_cast<int>(count), MPI_BYTE, root, comm);
+    }
+
+    FileAccessProps fapl;
+    fapl.add(MetadataSnapshotAccess(&image));
+    return File(metadata_snapshot_name(), File::ReadOnly, fapl);
+}
+
+}  // namespace details
+
+inline File createMetadataSnapshot(const File& file, MPI_Comm comm, int root) {
+    return details::broadcast_metadata_image(
+        [&file]() { return details::create_metadata_image(file.getId()); }, comm, root);
+}
+
+inline File createMetadataSnapshot(const std::string& filename,
+                                   MPI_Comm comm,
+                                   int root,
+                                   const FileAccessProps& fapl) {
+    return details::broadcast_metadata_image(
+        [&]() {
+            File file(filename, File::ReadOnly, fapl);
+            return details::create_metadata_image(file.getId());
+        },
+        comm,
+        root);
+}
+
+}  // namespace HighFive
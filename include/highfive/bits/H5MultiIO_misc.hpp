@@ -0,0 +1,176 @@
+/*
+ *  Copyright (c), 2023, Blue Brain Project - EPFL
+ *
+ *  Distributed under the Boost Software License, Version 1.0.
+ *    (See accompanying file LICENSE_1_0.txt or copy at
+ *          http://www.boost.org/LICENSE_1_0.txt)
+ *
+ */
+#pragma once
+
+#include <chrono>
+
+#include <H5Dpublic.h>
+
+#include "../H5IOTrace.hpp"
+#include "../H5Selection.hpp"
+
+namespace HighFive {
+
+namespace details {
+
+template <typename T>
+inline std::vector<hid_t> get_ids(const std::vector<T>& objects) {
+    std::vector<hid_t> ids;
+    ids.reserve(objects.size());
+    for (const auto& obj: objects) {
+        ids.push_back(obj.getId());
+    }
+    return ids;
+}
+
+}  // namespace details
+
+template <typename Derivate, typename T>
+inline void MultiIO::add(const SliceTraits<Derivate>& slice, T* buffer) {
+    using element_type = typename details::inspector<T>::base_type;
+    _add(slice, create_and_check_datatype<element_type>(), static_cast<void*>(buffer), false);
+}
+
+template <typename Derivate, typename T>
+inline void MultiIO::add(const SliceTraits<Derivate>& slice, const T* buffer) {
+    using element_type = typename details::inspector<T>::base_type;
+    _add(slice,
+         create_and_check_datatype<element_type>(),
+         const_cast<void*>(static_cast<const void*>(buffer)),
+         true);
+}
+
+template <typename Derivate>
+inline void MultiIO::add(const SliceTraits<Derivate>& slice,
+                         void* buffer,
+                         const DataType& mem_datatype) {
+    _add(slice, mem_datatype, buffer, false);
+}
+
+template <typename Derivate>
+inline void MultiIO::_add(const SliceTraits<Derivate>& slice,
+                          const DataType& mem_datatype,
+                          void* buffer,
+                          bool read_only) {
+    const auto& derivate = static_cast<const Derivate&>(slice);
+    _datasets.push_back(details::get_dataset(derivate));
+    _mem_types.push_back(mem_datatype);
+    _mem_spaces.push_back(derivate.getMemSpace());
+    _file_spaces.push_back(derivate.getSpace());
+    _buffers.push_back(buffer);
+    _read_only = _read_only || read_only;
+}
+
+inline void MultiIO::read(const DataTransferProps& xfer_props) const {
+    if (_read_only) {
+        throw DataSetException("MultiIO: unable to read into read-only buffers.");
+    }
+    if (_datasets.empty()) {
+        return;
+    }
+
+    auto dataset_ids = details::get_ids(_datasets);
+    auto mem_type_ids = details::get_ids(_mem_types);
+    auto mem_space_ids = details::get_ids(_mem_spaces);
+    auto file_space_ids = details::get_ids(_file_spaces);
+
+#if H5_VERSION_GE(1, 14, 0)
+    auto buffers = _buffers;
+    const auto start = std::chrono::steady_clock::now();
+    if (H5Dread_multi(dataset_ids.size(),
+                      dataset_ids.data(),
+                      mem_type_ids.data(),
+                      mem_space_ids.data(),
+                      file_space_ids.data(),
+                      xfer_props.getId(),
+                      buffers.data()) < 0) {
+        HDF5ErrMapper::ToException<DataSetException>("Error during HDF5 multi-dataset Read.");
+    }
+    if (IOTrace::isActive()) {
+        const auto stop = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < dataset_ids.size(); ++i) {
+            IOTrace::record(
+                IOTrace::Operation::Read, dataset_ids[i], file_space_ids[i], start, stop);
+        }
+    }
+#else
+    for (size_t i = 0; i < dataset_ids.size(); ++i) {
+        details::IOTraceScope trace(IOTrace::Operation::Read, dataset_ids[i], file_space_ids[i]);
+        if (H5Dread(dataset_ids[i],
+                    mem_type_ids[i],
+                    mem_space_ids[i],
+                    file_space_ids[i],
+                    xfer_props.getId(),
+                    _buffers[i]) < 0) {
+            HDF5ErrMapper::ToException<DataSetException>("Error during HDF5 Read.");
+        }
+        trace.succeeded();
+    }
+#endif
+}
+
+inline void MultiIO::write(const DataTransferProps& xfer_props) const {
+    if (_datasets.empty()) {
+        return;
+    }
+
+    auto dataset_ids = details::get_ids(_datasets);
+    auto mem_type_ids = details::get_ids(_mem_types);
+    auto mem_space_ids = details::get_ids(_mem_spaces);
+    auto file_space_ids = details::get_ids(_file_spaces);
+
+#if H5_VERSION_GE(1, 14, 0)
+    std::vector<const void*> buffers(_buffers.begin(), _buffers.end());
+    const auto start = std::chrono::steady_clock::now();
+    if (H5Dwrite_multi(dataset_ids.size(),
+                       dataset_ids.data(),
+                       mem_type_ids.data(),
+                       mem_space_ids.data(),
+                       file_space_ids.data(),
+                       xfer_props.getId(),
+                       buffers.data()) < 0) {
+        HDF5ErrMapper::ToException<DataSetException>("Error during HDF5 multi-dataset Write.");
+    }
+    if (IOTrace::isActive()) {
+        const auto stop = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < dataset_ids.size(); ++i) {
+            IOTrace::record(
+                IOTrace::Operation::Write, dataset_ids[i], file_space_ids[i], start, stop);
+        }
+    }
+#else
+    for (size_t i = 0; i < dataset_ids.size(); ++i) {
+        details::IOTraceScope trace(IOTrace::Operation::Write, dataset_ids[i], file_space_ids[i]);
+        if (H5Dwrite(dataset_ids[i],
+                     mem_type_ids[i],
+                     mem_space_ids[i],
+                     file_space_ids[i],
+                     xfer_props.getId(),
+                     _buffers[i]) < 0) {
+            HDF5ErrMapper::ToException<DataSetException>("Error during HDF5 Write: ");
+        }
+        trace.succeeded();
+    }
+#endif
+}
+
+inline size_t MultiIO::size() const noexcept {
+    return _datasets.size();
+}
+
+inline void MultiIO::clear() noexcept {
+    _datasets.clear();
+    _mem_types.clear();
+    _mem_spaces.clear();
+    _file_spaces.clear();
+    _buffers.clear();
+    _read_only = false;
+}
+
+}  // namespace HighFive
@@ -0,0 +1,109 @@
+/*
+ *  Copyright (c), 2023, Blue Brain Project - EPFL
+ *
+ *  Distributed under the Boost Software License, Version 1.0.
+ *    (See accompanying file LICENSE_1_0.txt or copy at
+ *          http://www.boost.org/LICENSE_1_0.txt)
+ *
+ */
+#pragma once
+
+#include <exception>
+#include <type_traits>
+
+namespace HighFive {
+
+template <typename T>
+inline NodeSharedDataSet<T>::NodeSharedDataSet(const DataSet& dataset,
+                                               MPI_Comm comm,
+                                               const DataTransferProps& xfer_props)
+    : _dims(dataset.getDimensions()) {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "NodeSharedDataSet requires a trivially copyable type.");
+
+    _size = compute_total_size(_dims);
+
+    MPI_Comm_split_type(comm, MPI_COMM_TYPE_SHARED, 0, MPI_INFO_NULL, &_node_comm);
+    int node_rank = 0;
+    MPI_Comm_rank(_node_comm, &node_rank);
+
+    // Only the first rank of the node allocates memory.
+    const auto n_bytes = static_cast<MPI_Aint>(node_rank == 0 ? _size * sizeof(T) : 0);
+    T* base = nullptr;
+    MPI_Win_allocate_shared(n_bytes, int(sizeof(T)), MPI_INFO_NULL, _node_comm, &base, &_window);
+
+    T* shared = base;
+    if (node_rank != 0) {
+        MPI_Aint size = 0;
+        int disp_unit = 0;
+        MPI_Win_shared_query(_window, 0, &size, &disp_unit, &shared);
+    }
+
+    std::exception_ptr error;
+    MPI_Win_fence(0, _window);
+    if (node_rank == 0 && _size > 0) {
+        try {
+            dataset.read(shared, xfer_props);
+        } catch (...) {
+            error = std::current_exception();
+        }
+    }
+    MPI_Win_fence(0, _window);
+
+    int local_failed = error ? 1 : 0, failed = 0;
+    MPI_Allreduce(&local_failed, &failed, 1, MPI_INT, MPI_MAX, _node_comm);
+    if (failed) {
+        _free();
+        if (error) {
+            std::rethrow_exception(error);
+        }
+        throw DataSetException("NodeSharedDataSet: unable to read the dataset on this node.");
+    }
+
+    _data = shared;
+}
+
+template <typename T>
+inline NodeSharedDataSet<T>::NodeSharedDataSet(NodeSharedDataSet&& other) noexcept
+    : _node_comm(other._node_comm)
+    , _window(other._window)
+    , _data(other._data)
+    , _size(other._size)
+    , _dims(std::move(other._dims)) {
+    other._node_comm = MPI_COMM_NULL;
+    other._window = MPI_WIN_NULL;
+    other._data = nullptr;
+    other._size = 0;
+}
+
+template <typename T>
+inline NodeSharedDataSet<T>& NodeSharedDataSet<T>::operator=(NodeSharedDataSet&& other) noexcept {
+    if (this != &other) {
+        _free();
+        std::swap(_node_comm, other._node_comm);
+        std::swap(_window, other._window);
+        std::swap(_data, other._data);
+        std::swap(_size, other._size);
+        std::swap(_dims, other._dims);
+    }
+    return *this;
+}
+
+template <typename T>
+inline NodeSharedDataSet<T>::~NodeSharedDataSet() {
+    _free();
+}
+
+template <typename T>
+inline void NodeSharedDataSet<T>::_free() noexcept {
+    if (_window != MPI_WIN_NULL) {
+        MPI_Win_free(&_window);
+    }
+    if (_node_comm != MPI_COMM_NULL) {
+        MPI_Comm_free(&_node_comm);
+    }
+    _data = nullptr;
+    _size = 0;
+}
+
+}  // namespace HighFive
@@ -8,6 +8,7 @@
  */
 #pragma once
 
+#include <functional>
 #include <string>
 
 #include "../H5PropertyList.hpp"
@@ -21,6 +22,32 @@ enum class IndexType : std::underlying_type<H5_index_t>::type {
     CRT_ORDER = H5_INDEX_CRT_ORDER,
 };
 
+///
+/// \brief How `NodeTraits::copyTo` re-creates the datasets it copies.
+///
+struct RepackOptions {
+    /// Returns the creation properties of the copy of a dataset, e.g. its
+    /// chunking and filters. By default, those of the original.
+    std::function<DataSetCreateProps(const DataSet&)> dataset_props;
+
+    /// Returns the datatype of the copy of a dataset, e.g. to store doubles as
+    /// floats. HDF5 converts the data while reading it. By default, the
+    /// datatype of the original.
+    std::function<DataType(const DataSet&)> dataset_type;
+
+    /// Approximate size in bytes of the slabs used to copy the data.
+    size_t buffer_size = 64 * 1024 * 1024;
+
+    /// The number of threads compressing the chunks of the copies.
+    ///
+    /// With more than one thread, and if HighFive is built with zlib, see
+    /// `H5_USE_ZLIB`, chunks filtered only by `Shuffle` and `Deflate` are
+    /// compressed outside of HDF5 by a pool of threads, while the next slab is
+    /// read, and written as is with `H5Dwrite_chunk`. Other datasets are
+    /// compressed by HDF5, on the calling thread.
+    size_t n_threads = 1;
+};
+
 ///
 /// \brief NodeTraits: Base class for Group and File
 ///
@@ -222,6 +249,55 @@ class NodeTraits {
                         const LinkAccessProps& linkAccessProps = LinkAccessProps(),
                         const bool parents = true);
 
+    ///
+    /// \brief Copies this node and everything below it to `dst_name` in `dst_node`
+    ///
+    /// This is a wrapper around `H5Ocopy`. The destination may reside in a
+    /// different file. The raw data is copied as stored, i.e. without being
+    /// decompressed or converted, which makes this the fastest way of copying.
+    /// \param dst_node The File or Group in which the copy is created
+    /// \param dst_name The name of the copy, relative to `dst_node`
+    /// \param copyProps Object copy properties, e.g. `CopyObjectFlags`
+    /// \param parents Create intermediate groups if needed. Default: true.
+    template <typename Node>
+    void copyTo(NodeTraits<Node>& dst_node,
+                const std::string& dst_name,
+                const ObjectCopyProps& copyProps = ObjectCopyProps::Default(),
+                bool parents = true) const;
+
+    ///
+    /// \brief Copies this node to `dst_name` in `dst_node`, re-creating every dataset
+    ///
+    /// Needed when the copies should differ from the original, e.g. to change
+    /// the chunking, the compression or the datatype, see `RepackOptions`.
+    /// Groups, attributes and links are recreated. The data is streamed in
+    /// slabs of about `options.buffer_size` bytes which are aligned with the
+    /// chunks of the copy, so that every chunk is compressed exactly once.
+    ///
+    /// Note that hard links to the same object are copied once per link.
+    /// \param dst_node The File or Group in which the copy is created
+    /// \param dst_name The name of the copy, relative to `dst_node`
+    /// \param options How to re-create the datasets
+    template <typename Node>
+    void copyTo(NodeTraits<Node>& dst_node,
+                const std::string& dst_name,
+                const RepackOptions& options) const;
+
+    ///
+    /// \brief Copies this node to `dst_name` in `dst_node`, re-creating every dataset
+    ///
+    /// Same as `copyTo(dst_node, dst_name, options)`, with the creation
+    /// properties of the copies returned by `dataset_props`.
+    /// \param dst_node The File or Group in which the copy is created
+    /// \param dst_name The name of the copy, relative to `dst_node`
+    /// \param dataset_props Returns the creation properties of the copy of a dataset
+    /// \param buffer_size Approximate size in bytes of the slabs used to copy data
+    template <typename Node>
+    void copyTo(NodeTraits<Node>& dst_node,
+                const std::string& dst_name,
+                const std::function<DataSetCreateProps(const DataSet&)>& dataset_props,
+                size_t buffer_size = 64 * 1024 * 1024) const;
+
   private:
     using derivate_type = Derivate;
 
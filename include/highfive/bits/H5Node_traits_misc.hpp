@@ -21,9 +21,11 @@
 #include "../H5DataSet.hpp"
 #include "../H5Group.hpp"
 #include "../H5Selection.hpp"
+#include "../H5Timeline.hpp"
 #include "../H5Utility.hpp"
 #include "H5DataSet_misc.hpp"
 #include "H5Iterables_misc.hpp"
+#include "H5Repack_misc.hpp"
 #include "H5Selection_misc.hpp"
 #include "H5Slice_traits_misc.hpp"
 
@@ -37,6 +39,7 @@ inline DataSet NodeTraits<Derivate>::createDataSet(const std::string& dataset_na
                                                    const DataSetCreateProps& createProps,
                                                    const DataSetAccessProps& accessProps,
                                                    bool parents) {
+    HIGHFIVE_TIMELINE_SPAN("createDataSet", dataset_name);
     LinkCreateProps lcpl;
     lcpl.add(CreateIntermediateGroup(parents));
     const auto hid = H5Dcreate2(static_cast<Derivate*>(this)->getId(),
@@ -92,6 +95,7 @@ inline DataSet NodeTraits<Derivate>::createDataSet(const std::string& dataset_na
                                                    const DataSetCreateProps& createProps,
                                                    const DataSetAccessProps& accessProps,
                                                    bool parents) {
+    HIGHFIVE_TIMELINE_SPAN("createDataSet", dataset_name);
     DataSet ds =
         createDataSet(dataset_name,
                       DataSpace::From(data),
@@ -110,6 +114,7 @@ inline DataSet NodeTraits<Derivate>::createDataSet(const std::string& dataset_na
                                                    const DataSetCreateProps& createProps,
                                                    const DataSetAccessProps& accessProps,
                                                    bool parents) {
+    HIGHFIVE_TIMELINE_SPAN("createDataSet", dataset_name);
     DataSet ds = createDataSet<char[N]>(
         dataset_name, DataSpace(data.size()), createProps, accessProps, parents);
     ds.write(data);
@@ -119,6 +124,7 @@ inline DataSet NodeTraits<Derivate>::createDataSet(const std::string& dataset_na
 template <typename Derivate>
 inline DataSet NodeTraits<Derivate>::getDataSet(const std::string& dataset_name,
                                                 const DataSetAccessProps& accessProps) const {
+    HIGHFIVE_TIMELINE_SPAN("getDataSet", dataset_name);
     const auto hid = H5Dopen2(static_cast<const Derivate*>(this)->getId(),
                               dataset_name.c_str(),
                               accessProps.getId());
@@ -131,6 +137,7 @@ inline DataSet NodeTraits<Derivate>::getDataSet(const std::string& dataset_name,
 
 template <typename Derivate>
 inline Group NodeTraits<Derivate>::createGroup(const std::string& group_name, bool parents) {
+    HIGHFIVE_TIMELINE_SPAN("createGroup", group_name);
     LinkCreateProps lcpl;
     lcpl.add(CreateIntermediateGroup(parents));
     const auto hid = H5Gcreate2(static_cast<Derivate*>(this)->getId(),
@@ -149,6 +156,7 @@ template <typename Derivate>
 inline Group NodeTraits<Derivate>::createGroup(const std::string& group_name,
                                                const GroupCreateProps& createProps,
                                                bool parents) {
+    HIGHFIVE_TIMELINE_SPAN("createGroup", group_name);
     LinkCreateProps lcpl;
     lcpl.add(CreateIntermediateGroup(parents));
     const auto hid = H5Gcreate2(static_cast<Derivate*>(this)->getId(),
@@ -165,6 +173,7 @@ inline Group NodeTraits<Derivate>::createGroup(const std::string& group_name,
 
 template <typename Derivate>
 inline Group NodeTraits<Derivate>::getGroup(const std::string& group_name) const {
+    HIGHFIVE_TIMELINE_SPAN("getGroup", group_name);
     const auto hid =
         H5Gopen2(static_cast<const Derivate*>(this)->getId(), group_name.c_str(), H5P_DEFAULT);
     if (hid < 0) {
@@ -220,6 +229,7 @@ inline bool NodeTraits<Derivate>::rename(const std::string& src_path,
 
 template <typename Derivate>
 inline std::vector<std::string> NodeTraits<Derivate>::listObjectNames(IndexType idx_type) const {
+    HIGHFIVE_TIMELINE_SPAN("listObjectNames");
     std::vector<std::string> names;
     details::HighFiveIterateData iterateData(names);
 
@@ -259,6 +269,7 @@ inline bool NodeTraits<Derivate>::_exist(const std::string& node_name, bool rais
 
 template <typename Derivate>
 inline bool NodeTraits<Derivate>::exist(const std::string& group_path) const {
+    HIGHFIVE_TIMELINE_SPAN("exist", group_path);
     // When there are slashes, first check everything is fine
     // so that subsequent errors are only due to missing intermediate groups
     if (group_path.find('/') != std::string::npos) {
@@ -382,6 +393,209 @@ inline void NodeTraits<Derivate>::createHardLink(const std::string& link_name,
 }
 
 
+template <typename Derivate>
+template <typename Node>
+inline void NodeTraits<Derivate>::copyTo(NodeTraits<Node>& dst_node,
+                                         const std::string& dst_name,
+                                         const ObjectCopyProps& copyProps,
+                                         bool parents) const {
+    LinkCreateProps lcpl;
+    lcpl.add(CreateIntermediateGroup(parents));
+    auto status = H5Ocopy(static_cast<const Derivate*>(this)->getId(),
+                          ".",
+                          static_cast<Node&>(dst_node).getId(),
+                          dst_name.c_str(),
+                          copyProps.getId(),
+                          lcpl.getId());
+    if (status < 0) {
+        HDF5ErrMapper::ToException<GroupException>(std::string("Unable to copy to \"") +
+                                                   dst_name + "\":");
+    }
+}
+
+namespace details {
+
+// The value of a soft or external link, as returned by `H5Lget_val`.
+inline std::vector<char> get_link_value(hid_t loc_id, const std::string& link_name) {
+    H5L_info_t linkinfo;
+    if (H5Lget_info(loc_id, link_name.c_str(), &linkinfo, H5P_DEFAULT) < 0) {
+        HDF5ErrMapper::ToException<GroupException>(std::string("Unable to obtain info for link ") +
+                                                   link_name);
+    }
+
+    std::vector<char> value(linkinfo.u.val_size);
+    if (H5Lget_val(loc_id, link_name.c_str(), value.data(), value.size(), H5P_DEFAULT) < 0) {
+        HDF5ErrMapper::ToException<GroupException>(
+            std::string("Unable to obtain value of link ") + link_name);
+    }
+    return value;
+}
+
+inline void reclaim_raw_buffer(const DataType& dtype, const DataSpace& space, void* buffer) {
+    if (H5Tdetect_class(dtype.getId(), H5T_VLEN) > 0 || dtype.isVariableStr()) {
+#if H5_VERSION_GE(1, 12, 0)
+        (void) H5Treclaim(dtype.getId(), space.getId(), H5P_DEFAULT, buffer);
+#else
+        (void) H5Dvlen_reclaim(dtype.getId(), space.getId(), H5P_DEFAULT, buffer);
+#endif
+    }
+}
+
+template <typename Src, typename Dst>
+inline void copy_attributes(const AnnotateTraits<Src>& src, AnnotateTraits<Dst>& dst) {
+    std::vector<char> buffer;
+    for (const auto& name: src.listAttributeNames()) {
+        auto src_attr = src.getAttribute(name);
+        auto dtype = src_attr.getDataType();
+        auto space = src_attr.getSpace();
+
+        auto dst_attr = dst.createAttribute(name, space, dtype);
+        buffer.resize(space.getElementCount() * dtype.getSize());
+        if (buffer.empty()) {
+            continue;
+        }
+
+        // Reading with the file datatype avoids any conversion.
+        src_attr.read(buffer.data(), dtype);
+        dst_attr.write_raw(buffer.data(), dtype);
+        reclaim_raw_buffer(dtype, space, buffer.data());
+    }
+}
+
+inline void repack_dataset(const DataSet& src,
+                           Group& dst_group,
+                           const std::string& dst_name,
+                           const RepackOptions& options) {
+    // The data is read with the datatype of the copy, HDF5 converts it.
+    auto dtype = options.dataset_type ? options.dataset_type(src) : src.getDataType();
+    auto dcpl = options.dataset_props ? options.dataset_props(src) : src.getCreatePropertyList();
+    auto file_space = src.getSpace();
+    auto dst = dst_group.createDataSet(dst_name, file_space, dtype, dcpl);
+    copy_attributes(src, dst);
+
+    std::vector<char> buffer;
+    auto dims = toHDF5SizeVector(file_space.getDimensions());
+    if (H5Sget_simple_extent_type(file_space.getId()) != H5S_SIMPLE) {
+        if (file_space.getElementCount() != 0) {
+            buffer.resize(dtype.getSize());
+            src.read(buffer.data(), dtype);
+            dst.write_raw(buffer.data(), dtype);
+            reclaim_raw_buffer(dtype, file_space, buffer.data());
+        }
+        return;
+    }
+
+    if (file_space.getElementCount() == 0) {
+        return;
+    }
+
+    // Copy along the slowest dimension, in slabs containing as many complete
+    // chunks of the copy as fit into `buffer_size`.
+    size_t row_size = dtype.getSize();
+    for (size_t i = 1; i < dims.size(); ++i) {
+        row_size *= dims[i];
+    }
+
+    hsize_t n_rows = std::max(hsize_t(1), hsize_t(options.buffer_size / row_size));
+    if (H5Pget_layout(dcpl.getId()) == H5D_CHUNKED) {
+        std::vector<hsize_t> chunk_dims(dims.size());
+        if (H5Pget_chunk(dcpl.getId(), static_cast<int>(chunk_dims.size()), chunk_dims.data()) >=
+            0) {
+            n_rows = std::max(chunk_dims[0], n_rows - n_rows % chunk_dims[0]);
+
+            std::vector<OffLockFilter> filters;
+            if (options.n_threads > 1 && is_fixed_size(dtype) &&
+                get_off_lock_filters(dst.getCreatePropertyList(), filters)) {
+                repack_chunks_off_lock(
+                    src, dst, dtype, filters, dims, chunk_dims, n_rows, options.n_threads);
+                return;
+            }
+        }
+    }
+
+    for (hsize_t row = 0; row < dims[0]; row += n_rows) {
+        auto offset = std::vector<hsize_t>(dims.size(), 0);
+        auto count = dims;
+        offset[0] = row;
+        count[0] = std::min(n_rows, dims[0] - row);
+
+        auto slab = HyperSlab(RegularHyperSlab::fromHDF5Sizes(offset, count));
+        auto memspace = DataSpace(toSTLSizeVector(count));
+        buffer.resize(memspace.getElementCount() * dtype.getSize());
+
+        src.select(slab, memspace).read(buffer.data(), dtype);
+        dst.select(slab, memspace).write_raw(buffer.data(), dtype);
+        reclaim_raw_buffer(dtype, memspace, buffer.data());
+    }
+}
+
+}  // namespace details
+
+template <typename Derivate>
+template <typename Node>
+inline void NodeTraits<Derivate>::copyTo(
+    NodeTraits<Node>& dst_node,
+    const std::string& dst_name,
+    const std::function<DataSetCreateProps(const DataSet&)>& dataset_props,
+    size_t buffer_size) const {
+    RepackOptions options;
+    options.dataset_props = dataset_props;
+    options.buffer_size = buffer_size;
+    copyTo(dst_node, dst_name, options);
+}
+
+template <typename Derivate>
+template <typename Node>
+inline void NodeTraits<Derivate>::copyTo(NodeTraits<Node>& dst_node,
+                                         const std::string& dst_name,
+                                         const RepackOptions& options) const {
+    const auto& src = static_cast<const Derivate&>(*this);
+    const auto src_root = getGroup(".");
+
+    auto dst_group = dst_node.createGroup(dst_name, src_root.getCreatePropertyList());
+    details::copy_attributes(src_root, dst_group);
+
+    for (const auto& name: listObjectNames()) {
+        auto link_type = getLinkType(name);
+        if (link_type == LinkType::Soft) {
+            auto value = details::get_link_value(src.getId(), name);
+            dst_group.createSoftLink(name, std::string(value.data()));
+            continue;
+        }
+
+        if (link_type == LinkType::External) {
+            auto value = details::get_link_value(src.getId(), name);
+            const char* h5_file = nullptr;
+            const char* obj_path = nullptr;
+            if (H5Lunpack_elink_val(value.data(), value.size(), nullptr, &h5_file, &obj_path) < 0) {
+                HDF5ErrMapper::ToException<GroupException>(
+                    std::string("Unable to unpack external link ") + name);
+            }
+            dst_group.createExternalLink(name, h5_file, obj_path);
+            continue;
+        }
+
+        auto object_type = getObjectType(name);
+        if (object_type == ObjectType::Group) {
+            getGroup(name).copyTo(dst_group, name, options);
+        } else if (object_type == ObjectType::Dataset) {
+            auto dataset = getDataSet(name);
+            details::repack_dataset(dataset, dst_group, name, options);
+        } else {
+            // Committed datatypes and other objects don't have a layout.
+            if (H5Ocopy(src.getId(),
+                        name.c_str(),
+                        dst_group.getId(),
+                        name.c_str(),
+                        H5P_DEFAULT,
+                        H5P_DEFAULT) < 0) {
+                HDF5ErrMapper::ToException<GroupException>(std::string("Unable to copy \"") +
+                                                           name + "\":");
+            }
+        }
+    }
+}
+
 template <typename Derivate>
 inline Object NodeTraits<Derivate>::_open(const std::string& node_name,
                                           const DataSetAccessProps& accessProps) const {
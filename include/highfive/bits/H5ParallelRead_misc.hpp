@@ -0,0 +1,382 @@
+/*
+ *  Copyright (c), 2023, Blue Brain Project - EPFL
+ *
+ *  Distributed under the Boost Software License, Version 1.0.
+ *    (See accompanying file LICENSE_1_0.txt or copy at
+ *          http://www.boost.org/LICENSE_1_0.txt)
+ *
+ */
+#pragma once
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <exception>
+#include <type_traits>
+
+#include <H5Dpublic.h>
+#include <H5Spublic.h>
+
+#include "../H5IOTrace.hpp"
+
+namespace HighFive {
+
+namespace details {
+
+// A hyperslab given by its offset and shape.
+struct Box {
+    std::vector<size_t> offset;
+    std::vector<size_t> count;
+
+    size_t size() const {
+        return compute_total_size(count);
+    }
+};
+
+// Intersects `a` and `b`; returns false if the intersection is empty.
+inline bool intersect(const Box& a, const Box& b, Box& result) {
+    const size_t n_dims = a.offset.size();
+    result.offset.resize(n_dims);
+    result.count.resize(n_dims);
+    for (size_t d = 0; d < n_dims; ++d) {
+        size_t begin = std::max(a.offset[d], b.offset[d]);
+        size_t end = std::min(a.offset[d] + a.count[d], b.offset[d] + b.count[d]);
+        if (end <= begin) {
+            return false;
+        }
+        result.offset[d] = begin;
+        result.count[d] = end - begin;
+    }
+    return true;
+}
+
+// Copies the box of shape `count` at `src_offset` in the row-major array
+// `src` of shape `src_dims` to `dst_offset` in the row-major array `dst` of
+// shape `dst_dims`.
+inline void copy_box(const char* src,
+                     const std::vector<size_t>& src_dims,
+                     const std::vector<size_t>& src_offset,
+                     char* dst,
+                     const std::vector<size_t>& dst_dims,
+                     const std::vector<size_t>& dst_offset,
+                     const std::vector<size_t>& count,
+                     size_t element_size) {
+    const size_t n_dims = count.size();
+    const size_t row_size = count.back() * element_size;
+
+    size_t n_rows = 1;
+    for (size_t d = 0; d + 1 < n_dims; ++d) {
+        n_rows *= count[d];
+    }
+
+    std::vector<size_t> index(n_dims, 0);
+    for (size_t row = 0; row < n_rows; ++row) {
+        size_t src_linear = 0, dst_linear = 0;
+        for (size_t d = 0; d < n_dims; ++d) {
+            src_linear = src_linear * src_dims[d] + src_offset[d] + index[d];
+            dst_linear = dst_linear * dst_dims[d] + dst_offset[d] + index[d];
+        }
+        std::memcpy(dst + dst_linear * element_size, src + src_linear * element_size, row_size);
+
+        for (size_t d = n_dims - 1; d-- > 0;) {
+            if (++index[d] < count[d]) {
+                break;
+            }
+            index[d] = 0;
+        }
+    }
+}
+
+inline std::vector<size_t> relative_offset(const Box& inner, const Box& outer) {
+    std::vector<size_t> offset(inner.offset.size());
+    for (size_t d = 0; d < offset.size(); ++d) {
+        offset[d] = inner.offset[d] - outer.offset[d];
+    }
+    return offset;
+}
+
+// Sends `sizes[r]` bytes at `send_buffer + send_displs[r]` to every rank
+// `r`, and receives `recv_sizes[r]` bytes from it at `recv_buffer +
+// recv_displs[r]`. Unlike `MPI_Alltoallv`, sizes and displacements may
+// exceed `INT_MAX`: messages are split into pieces of at most `INT_MAX`
+// bytes, which are exchanged on a duplicate of `comm`.
+inline void alltoallv_large(const char* send_buffer,
+                            const std::vector<size_t>& send_sizes,
+                            const std::vector<size_t>& send_displs,
+                            char* recv_buffer,
+                            const std::vector<size_t>& recv_sizes,
+                            const std::vector<size_t>& recv_displs,
+                            MPI_Comm comm) {
+    const size_t max_piece = static_cast<size_t>(INT_MAX);
+
+    MPI_Comm exchange_comm;
+    MPI_Comm_dup(comm, &exchange_comm);
+
+    std::vector<MPI_Request> requests;
+    for (size_t r = 0; r < recv_sizes.size(); ++r) {
+        for (size_t done = 0; done < recv_sizes[r]; done += max_piece) {
+            requests.emplace_back();
+            MPI_Irecv(recv_buffer + recv_displs[r] + done,
+                      static_cast<int>(std::min(max_piece, recv_sizes[r] - done)),
+                      MPI_BYTE,
+                      static_cast<int>(r),
+                      0,
+                      exchange_comm,
+                      &requests.back());
+        }
+    }
+    for (size_t r = 0; r < send_sizes.size(); ++r) {
+        for (size_t done = 0; done < send_sizes[r]; done += max_piece) {
+            requests.emplace_back();
+            MPI_Isend(send_buffer + send_displs[r] + done,
+                      static_cast<int>(std::min(max_piece, send_sizes[r] - done)),
+                      MPI_BYTE,
+                      static_cast<int>(r),
+                      0,
+                      exchange_comm,
+                      &requests.back());
+        }
+    }
+
+    MPI_Waitall(static_cast<int>(requests.size()), requests.data(), MPI_STATUSES_IGNORE);
+    MPI_Comm_free(&exchange_comm);
+}
+
+}  // namespace details
+
+template <typename T>
+inline std::vector<T> readRedistributed(const DataSet& dataset,
+                                        const std::vector<size_t>& offset,
+                                        const std::vector<size_t>& count,
+                                        MPI_Comm comm,
+                                        const DataTransferProps& xfer_props) {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "readRedistributed requires a trivially copyable type.");
+
+    // Errors of a single rank must be known to all ranks before throwing,
+    // otherwise the others would wait forever in the next collective call.
+    const auto dims = dataset.getDimensions();
+    const size_t n_dims = dims.size();
+    if (n_dims == 0) {
+        throw DataSpaceException("readRedistributed: the dataset is a scalar.");
+    }
+
+    bool valid = offset.size() == n_dims && count.size() == n_dims;
+    for (size_t d = 0; valid && d < n_dims; ++d) {
+        valid = offset[d] <= dims[d] && count[d] <= dims[d] - offset[d];
+    }
+
+    int mpi_rank = 0, mpi_size = 0;
+    MPI_Comm_rank(comm, &mpi_rank);
+    MPI_Comm_size(comm, &mpi_size);
+    const auto n_ranks = static_cast<size_t>(mpi_size);
+
+    // -- Every rank needs to know the blocks of all ranks, and whether they're valid.
+    const size_t n_values = 2 * n_dims + 1;
+    std::vector<unsigned long long> local(n_values, 0);
+    if (valid) {
+        std::copy(offset.begin(), offset.end(), local.begin());
+        std::copy(count.begin(), count.end(), local.begin() + long(n_dims));
+        local.back() = 1;
+    }
+    std::vector<unsigned long long> all(n_values * n_ranks);
+    MPI_Allgather(local.data(),
+                  int(n_values),
+                  MPI_UNSIGNED_LONG_LONG,
+                  all.data(),
+                  int(n_values),
+                  MPI_UNSIGNED_LONG_LONG,
+                  comm);
+
+    for (size_t r = 0; r < n_ranks; ++r) {
+        if (all[n_values * r + n_values - 1] == 0) {
+            throw DataSpaceException(
+                r == size_t(mpi_rank)
+                    ? "readRedistributed: the block isn't within the dataset."
+                    : "readRedistributed: the block of another rank isn't within the dataset.");
+        }
+    }
+
+    std::vector<details::Box> targets(n_ranks);
+    details::Box bounds;
+    bool has_bounds = false;
+    for (size_t r = 0; r < n_ranks; ++r) {
+        auto it = all.begin() + long(n_values * r);
+        targets[r].offset.assign(it, it + long(n_dims));
+        targets[r].count.assign(it + long(n_dims), it + long(2 * n_dims));
+        if (targets[r].size() == 0) {
+            continue;
+        }
+        if (!has_bounds) {
+            bounds = targets[r];
+            has_bounds = true;
+            continue;
+        }
+        for (size_t d = 0; d < n_dims; ++d) {
+            size_t end = std::max(bounds.offset[d] + bounds.count[d],
+                                  targets[r].offset[d] + targets[r].count[d]);
+            bounds.offset[d] = std::min(bounds.offset[d], targets[r].offset[d]);
+            bounds.count[d] = end - bounds.offset[d];
+        }
+    }
+
+    std::vector<T> result(compute_total_size(count));
+    if (!has_bounds) {
+        return result;
+    }
+
+    // -- Cut the bounding box into slabs which are aligned with the chunks.
+    size_t rows_per_chunk = 1;
+    auto dcpl = dataset.getCreatePropertyList();
+    if (H5Pget_layout(dcpl.getId()) == H5D_CHUNKED) {
+        rows_per_chunk = Chunking(dcpl).getDimensions()[0];
+    }
+
+    const size_t begin = bounds.offset[0] / rows_per_chunk * rows_per_chunk;
+    const size_t end = bounds.offset[0] + bounds.count[0];
+    const size_t n_chunk_rows = (end - begin + rows_per_chunk - 1) / rows_per_chunk;
+
+    auto get_slab = [&](size_t r) {
+        details::Box slab = bounds;
+        size_t first = begin + (r * n_chunk_rows / n_ranks) * rows_per_chunk;
+        size_t last = begin + ((r + 1) * n_chunk_rows / n_ranks) * rows_per_chunk;
+        first = std::max(first, bounds.offset[0]);
+        last = std::min(last, end);
+        slab.offset[0] = first;
+        slab.count[0] = last > first ? last - first : 0;
+        return slab;
+    };
+
+    // -- Read this rank's slab.
+    const auto slab = get_slab(static_cast<size_t>(mpi_rank));
+    std::vector<T> slab_data(slab.size());
+    std::exception_ptr read_error;
+    try {
+        using element_type = typename details::inspector<T>::base_type;
+        const auto& mem_datatype = create_and_check_datatype<element_type>();
+
+        auto file_space = dataset.getSpace();
+        auto mem_space = DataSpace({slab.size()});
+        if (slab.size() == 0) {
+            H5Sselect_none(file_space.getId());
+            H5Sselect_none(mem_space.getId());
+        } else {
+            std::vector<hsize_t> slab_offset(slab.offset.begin(), slab.offset.end());
+            std::vector<hsize_t> slab_count(slab.count.begin(), slab.count.end());
+            if (H5Sselect_hyperslab(file_space.getId(),
+                                    H5S_SELECT_SET,
+                                    slab_offset.data(),
+                                    nullptr,
+                                    slab_count.data(),
+                                    nullptr) < 0) {
+                HDF5ErrMapper::ToException<DataSpaceException>("Unable to select hyperslab");
+            }
+        }
+
+        details::IOTraceScope trace(IOTrace::Operation::Read,
+                                    dataset.getId(),
+                                    file_space.getId());
+        if (H5Dread(dataset.getId(),
+                    mem_datatype.getId(),
+                    mem_space.getId(),
+                    file_space.getId(),
+                    xfer_props.getId(),
+                    slab_data.data()) < 0) {
+            HDF5ErrMapper::ToException<DataSetException>("Error during HDF5 Read.");
+        }
+        trace.succeeded();
+    } catch (...) {
+        read_error = std::current_exception();
+    }
+
+    // -- Send every rank the part of the slab it needs.
+    const size_t element_size = sizeof(T);
+    std::vector<size_t> send_sizes(n_ranks, 0), send_displs(n_ranks, 0);
+    std::vector<size_t> recv_sizes(n_ranks, 0), recv_displs(n_ranks, 0);
+
+    std::vector<details::Box> send_boxes(n_ranks), recv_boxes(n_ranks);
+    size_t n_send = 0, n_recv = 0;
+    for (size_t r = 0; r < n_ranks; ++r) {
+        send_displs[r] = n_send * element_size;
+        if (details::intersect(slab, targets[r], send_boxes[r])) {
+            send_sizes[r] = send_boxes[r].size() * element_size;
+            n_send += send_boxes[r].size();
+        }
+
+        recv_displs[r] = n_recv * element_size;
+        if (details::intersect(get_slab(r), targets[size_t(mpi_rank)], recv_boxes[r])) {
+            recv_sizes[r] = recv_boxes[r].size() * element_size;
+            n_recv += recv_boxes[r].size();
+        }
+    }
+
+    // -- Agree on whether all slabs were read, and whether `MPI_Alltoallv`,
+    // whose counts and displacements are `int`, can exchange them.
+    const auto int_max = static_cast<size_t>(INT_MAX);
+    int local_flags[2] = {read_error ? 1 : 0,
+                          n_send * element_size > int_max || n_recv * element_size > int_max};
+    int flags[2] = {0, 0};
+    MPI_Allreduce(local_flags, flags, 2, MPI_INT, MPI_MAX, comm);
+    if (read_error) {
+        std::rethrow_exception(read_error);
+    }
+    if (flags[0] != 0) {
+        throw DataSetException("readRedistributed: reading the slab failed on another rank.");
+    }
+
+    std::vector<char> send_buffer(n_send * element_size);
+    for (size_t r = 0; r < n_ranks; ++r) {
+        if (send_sizes[r] > 0) {
+            details::copy_box(reinterpret_cast<const char*>(slab_data.data()),
+                              slab.count,
+                              details::relative_offset(send_boxes[r], slab),
+                              send_buffer.data() + send_displs[r],
+                              send_boxes[r].count,
+                              std::vector<size_t>(n_dims, 0),
+                              send_boxes[r].count,
+                              element_size);
+        }
+    }
+
+    std::vector<char> recv_buffer(n_recv * element_size);
+    if (flags[1] == 0) {
+        auto to_int = [](const std::vector<size_t>& values) {
+            return std::vector<int>(values.begin(), values.end());
+        };
+        MPI_Alltoallv(send_buffer.data(),
+                      to_int(send_sizes).data(),
+                      to_int(send_displs).data(),
+                      MPI_BYTE,
+                      recv_buffer.data(),
+                      to_int(recv_sizes).data(),
+                      to_int(recv_displs).data(),
+                      MPI_BYTE,
+                      comm);
+    } else {
+        details::alltoallv_large(send_buffer.data(),
+                                 send_sizes,
+                                 send_displs,
+                                 recv_buffer.data(),
+                                 recv_sizes,
+                                 recv_displs,
+                                 comm);
+    }
+
+    const auto& target = targets[size_t(mpi_rank)];
+    for (size_t r = 0; r < n_ranks; ++r) {
+        if (recv_sizes[r] > 0) {
+            details::copy_box(recv_buffer.data() + recv_displs[r],
+                              recv_boxes[r].count,
+                              std::vector<size_t>(n_dims, 0),
+                              reinterpret_cast<char*>(result.data()),
+                              target.count,
+                              details::relative_offset(recv_boxes[r], target),
+                              recv_boxes[r].count,
+                              element_size);
+        }
+    }
+
+    return result;
+}
+
+}  // namespace HighFive
@@ -23,13 +23,12 @@ class PathTraits {
     std::string getPath() const;
 
     ///
-    /// \brief Return a reference to the File object this object belongs
-    /// \return the File object ref
-    File& getFile() const noexcept;
-
-
-  protected:
-    std::shared_ptr<File> _file_obj;  // keep a ref to file so we keep its ref count > 0
+    /// \brief Return the File this object belongs to
+    ///
+    /// Every call opens a new handle of the file. As long as it exists, it
+    /// keeps the file open, even with `FileCloseDegree(H5F_CLOSE_STRONG)`.
+    /// \return A handle of the file
+    File getFile() const;
 };
 
 }  // namespace HighFive
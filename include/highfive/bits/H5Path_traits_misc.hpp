@@ -20,15 +20,6 @@ inline PathTraits<Derivate>::PathTraits() {
     static_assert(std::is_same<Derivate, Group>::value || std::is_same<Derivate, DataSet>::value ||
                       std::is_same<Derivate, Attribute>::value,
                   "PathTraits can only be applied to Group, DataSet and Attribute");
-    const auto& obj = static_cast<const Derivate&>(*this);
-    if (!obj.isValid()) {
-        return;
-    }
-    const hid_t file_id = H5Iget_file_id(obj.getId());
-    if (file_id < 0) {
-        HDF5ErrMapper::ToException<PropertyException>("getFile(): Could not obtain file of object");
-    }
-    _file_obj.reset(new File(file_id));
 }
 
 template <typename Derivate>
@@ -38,9 +29,17 @@ inline std::string PathTraits<Derivate>::getPath() const {
     });
 }
 
+// The handle isn't kept by the object: a handle held by every object would
+// keep the file open and defeat `H5F_CLOSE_STRONG`.
 template <typename Derivate>
-inline File& PathTraits<Derivate>::getFile() const noexcept {
-    return *_file_obj;
+inline File PathTraits<Derivate>::getFile() const {
+    const hid_t file_id = H5Iget_file_id(static_cast<const Derivate&>(*this).getId());
+    if (file_id < 0) {
+        HDF5ErrMapper::ToException<PropertyException>("getFile(): Could not obtain file of object");
+    }
+    File file(file_id);
+    file._held_by_object = true;
+    return file;
 }
 
 }  // namespace HighFive
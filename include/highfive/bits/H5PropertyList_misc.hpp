@@ -288,6 +288,141 @@ inline hsize_t MetadataBlockSize::getSize() const {
     return _size;
 }
 
+inline FileCloseDegree::FileCloseDegree(H5F_close_degree_t degree)
+    : _degree(degree) {}
+
+inline FileCloseDegree::FileCloseDegree(const FileAccessProps& fapl) {
+    if (H5Pget_fclose_degree(fapl.getId(), &_degree) < 0) {
+        HDF5ErrMapper::ToException<PropertyException>("Unable to access file close degree");
+    }
+}
+
+inline void FileCloseDegree::apply(const hid_t list) const {
+    if (H5Pset_fclose_degree(list, _degree) < 0) {
+        HDF5ErrMapper::ToException<PropertyException>("Error setting file close degree");
+    }
+}
+
+inline H5F_close_degree_t FileCloseDegree::getDegree() const {
+    return _degree;
+}
+
+inline SplitDriver::SplitDriver(const std::string& meta_ext,
+                                const std::string& raw_ext,
+                                const FileAccessProps& meta_fapl,
+                                const FileAccessProps& raw_fapl)
+    : _meta_ext(meta_ext)
+    , _raw_ext(raw_ext)
+    , _meta_fapl(meta_fapl)
+    , _raw_fapl(raw_fapl) {}
+
+inline void SplitDriver::apply(const hid_t list) const {
+    if (H5Pset_fapl_split(list,
+                          _meta_ext.c_str(),
+                          _meta_fapl.getId(),
+                          _raw_ext.c_str(),
+                          _raw_fapl.getId()) < 0) {
+        HDF5ErrMapper::ToException<PropertyException>("Error setting split driver");
+    }
+}
+
+inline MultiDriver::MultiDriver(const std::map<H5FD_mem_t, std::string>& members, bool relax)
+    : _members(members)
+    , _relax(relax) {
+    _members.emplace(H5FD_MEM_SUPER, "%s-s.h5");
+}
+
+inline void MultiDriver::apply(const hid_t list) const {
+    H5FD_mem_t memb_map[H5FD_MEM_NTYPES];
+    hid_t memb_fapl[H5FD_MEM_NTYPES];
+    const char* memb_name[H5FD_MEM_NTYPES];
+    haddr_t memb_addr[H5FD_MEM_NTYPES];
+
+    for (int i = 0; i < H5FD_MEM_NTYPES; ++i) {
+        memb_map[i] = H5FD_MEM_SUPER;
+        memb_fapl[i] = H5P_DEFAULT;
+        memb_name[i] = nullptr;
+        memb_addr[i] = HADDR_UNDEF;
+    }
+
+    // The address space is divided evenly among the members.
+    const haddr_t share = HADDR_MAX / _members.size();
+    haddr_t addr = 0;
+    for (const auto& member: _members) {
+        memb_map[member.first] = member.first;
+        memb_name[member.first] = member.second.c_str();
+        memb_addr[member.first] = addr;
+        addr += share;
+    }
+
+    if (H5Pset_fapl_multi(list, memb_map, memb_fapl, memb_name, memb_addr, _relax) < 0) {
+        HDF5ErrMapper::ToException<PropertyException>("Error setting multi driver");
+    }
+}
+
+inline FamilyDriver::FamilyDriver(hsize_t member_size, const FileAccessProps& member_fapl)
+    : _member_size(member_size)
+    , _member_fapl(member_fapl) {}
+
+namespace details {
+inline hid_t get_family_member_fapl(hid_t fapl) {
+    hsize_t member_size = 0;
+    hid_t member_fapl = H5I_INVALID_HID;
+    if (H5Pget_fapl_family(fapl, &member_size, &member_fapl) < 0) {
+        return H5I_INVALID_HID;
+    }
+    return member_fapl;
+}
+}  // namespace details
+
+inline FamilyDriver::FamilyDriver(const FileAccessProps& fapl)
+    : _member_fapl(details::get_plist<FileAccessProps>(fapl, details::get_family_member_fapl)) {
+    if (H5Pget_fapl_family(fapl.getId(), &_member_size, nullptr) < 0) {
+        HDF5ErrMapper::ToException<PropertyException>("Unable to access family driver properties");
+    }
+}
+
+inline void FamilyDriver::apply(const hid_t list) const {
+    if (H5Pset_fapl_family(list, _member_size, _member_fapl.getId()) < 0) {
+        HDF5ErrMapper::ToException<PropertyException>("Error setting family driver");
+    }
+}
+
+inline hsize_t FamilyDriver::getMemberSize() const {
+    return _member_size;
+}
+
+#ifdef H5_HAVE_DIRECT
+inline DirectIO::DirectIO(size_t alignment, size_t block_size, size_t cbuf_size)
+    : _alignment(alignment)
+    , _block_size(block_size)
+    , _cbuf_size(cbuf_size) {}
+
+inline DirectIO::DirectIO(const FileAccessProps& fapl) {
+    if (H5Pget_fapl_direct(fapl.getId(), &_alignment, &_block_size, &_cbuf_size) < 0) {
+        HDF5ErrMapper::ToException<PropertyException>("Unable to access direct I/O properties");
+    }
+}
+
+inline void DirectIO::apply(const hid_t list) const {
+    if (H5Pset_fapl_direct(list, _alignment, _block_size, _cbuf_size) < 0) {
+        HDF5ErrMapper::ToException<PropertyException>("Error setting direct I/O driver");
+    }
+}
+
+inline size_t DirectIO::getAlignment() const {
+    return _alignment;
+}
+
+inline size_t DirectIO::getBlockSize() const {
+    return _block_size;
+}
+
+inline size_t DirectIO::getCopyBufferSize() const {
+    return _cbuf_size;
+}
+#endif
+
 inline void EstimatedLinkInfo::apply(const hid_t hid) const {
     if (H5Pset_est_link_info(hid, _entries, _length) < 0) {
         HDF5ErrMapper::ToException<PropertyException>("Error setting estimated link info");
@@ -570,5 +705,50 @@ inline void AttributePhaseChange::apply(hid_t hid) const {
     }
 }
 
+inline LinkPhaseChange::LinkPhaseChange(unsigned max_compact, unsigned min_dense)
+    : _max_compact(max_compact)
+    , _min_dense(min_dense) {}
+
+inline LinkPhaseChange::LinkPhaseChange(const GroupCreateProps& gcpl) {
+    if (H5Pget_link_phase_change(gcpl.getId(), &_max_compact, &_min_dense) < 0) {
+        HDF5ErrMapper::ToException<PropertyException>(
+            "Error getting property for link phase change");
+    }
+}
+
+inline unsigned LinkPhaseChange::max_compact() const {
+    return _max_compact;
+}
+
+inline unsigned LinkPhaseChange::min_dense() const {
+    return _min_dense;
+}
+
+inline void LinkPhaseChange::apply(hid_t hid) const {
+    if (H5Pset_link_phase_change(hid, _max_compact, _min_dense) < 0) {
+        HDF5ErrMapper::ToException<PropertyException>(
+            "Error setting property for link phase change");
+    }
+}
+
+inline CopyObjectFlags::CopyObjectFlags(unsigned flags)
+    : _flags(flags) {}
+
+inline CopyObjectFlags::CopyObjectFlags(const ObjectCopyProps& ocpypl) {
+    if (H5Pget_copy_object(ocpypl.getId(), &_flags) < 0) {
+        HDF5ErrMapper::ToException<PropertyException>("Error getting object copy flags");
+    }
+}
+
+inline unsigned CopyObjectFlags::getFlags() const {
+    return _flags;
+}
+
+inline void CopyObjectFlags::apply(hid_t hid) const {
+    if (H5Pset_copy_object(hid, _flags) < 0) {
+        HDF5ErrMapper::ToException<PropertyException>("Error setting object copy flags");
+    }
+}
+
 
 }  // namespace HighFive
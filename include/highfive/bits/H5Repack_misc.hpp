@@ -0,0 +1,327 @@
+/*
+ *  Copyright (c), 2023, Blue Brain Project - EPFL
+ *
+ *  Distributed under the Boost Software License, Version 1.0.
+ *    (See accompanying file LICENSE_1_0.txt or copy at
+ *          http://www.boost.org/LICENSE_1_0.txt)
+ *
+ */
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <H5Dpublic.h>
+#include <H5Ppublic.h>
+#include <H5Zpublic.h>
+
+#ifdef H5_USE_ZLIB
+#include <zlib.h>
+#endif
+
+#include "../H5DataSet.hpp"
+#include "../H5Selection.hpp"
+
+namespace HighFive {
+
+namespace details {
+
+// A filter which HighFive applies itself when repacking, see `get_off_lock_filters`.
+struct OffLockFilter {
+    H5Z_filter_t id;
+    // The size of the elements for `Shuffle`, the level for `Deflate`.
+    unsigned parameter;
+};
+
+inline bool is_fixed_size(const DataType& dtype) {
+    return H5Tdetect_class(dtype.getId(), H5T_VLEN) <= 0 && !dtype.isVariableStr();
+}
+
+// The filters of `dcpl`, the creation properties of an existing dataset, if
+// all of them can be applied outside of HDF5. Requires zlib and
+// `H5Dwrite_chunk`.
+inline bool get_off_lock_filters(const DataSetCreateProps& dcpl,
+                                 std::vector<OffLockFilter>& filters) {
+#if defined(H5_USE_ZLIB) && H5_VERSION_GE(1, 10, 2)
+    const int n_filters = H5Pget_nfilters(dcpl.getId());
+    if (n_filters <= 0) {
+        // Nothing to compress, HDF5 writes the chunks as fast.
+        return false;
+    }
+
+    for (unsigned i = 0; i < static_cast<unsigned>(n_filters); ++i) {
+        unsigned flags = 0;
+        unsigned values[8];
+        size_t n_values = 8;
+        const auto id =
+            H5Pget_filter2(dcpl.getId(), i, &flags, &n_values, values, 0, nullptr, nullptr);
+        if ((id != H5Z_FILTER_SHUFFLE && id != H5Z_FILTER_DEFLATE) || n_values < 1) {
+            return false;
+        }
+        filters.push_back({id, values[0]});
+    }
+    return true;
+#else
+    (void) dcpl;
+    (void) filters;
+    return false;
+#endif
+}
+
+// The same byte layout as the shuffle filter of HDF5.
+inline void shuffle_bytes(const std::vector<char>& in,
+                          std::vector<char>& out,
+                          size_t element_size) {
+    out.resize(in.size());
+    if (element_size <= 1) {
+        std::copy(in.begin(), in.end(), out.begin());
+        return;
+    }
+
+    const size_t n_elements = in.size() / element_size;
+    for (size_t j = 0; j < element_size; ++j) {
+        for (size_t i = 0; i < n_elements; ++i) {
+            out[j * n_elements + i] = in[i * element_size + j];
+        }
+    }
+    std::copy(in.begin() + std::ptrdiff_t(n_elements * element_size),
+              in.end(),
+              out.begin() + std::ptrdiff_t(n_elements * element_size));
+}
+
+#ifdef H5_USE_ZLIB
+// The same encoding as the deflate filter of HDF5.
+inline void deflate_bytes(const std::vector<char>& in, std::vector<char>& out, int level) {
+    uLongf size = compressBound(static_cast<uLong>(in.size()));
+    out.resize(size);
+    if (compress2(reinterpret_cast<Bytef*>(out.data()),
+                  &size,
+                  reinterpret_cast<const Bytef*>(in.data()),
+                  static_cast<uLong>(in.size()),
+                  level) != Z_OK) {
+        throw DataSetException("Unable to compress a chunk.");
+    }
+    out.resize(size);
+}
+#endif
+
+inline void apply_off_lock_filters(const std::vector<OffLockFilter>& filters,
+                                   std::vector<char>& chunk,
+                                   std::vector<char>& scratch) {
+    for (const auto& filter: filters) {
+        if (filter.id == H5Z_FILTER_SHUFFLE) {
+            shuffle_bytes(chunk, scratch, filter.parameter);
+        } else {
+#ifdef H5_USE_ZLIB
+            deflate_bytes(chunk, scratch, static_cast<int>(filter.parameter));
+#endif
+        }
+        chunk.swap(scratch);
+    }
+}
+
+// A slab of rows of the source, and the compressed chunks of the copy it holds.
+struct RepackSlab {
+    std::vector<hsize_t> offset;
+    std::vector<hsize_t> count;
+    std::vector<char> data;
+
+    std::vector<std::vector<hsize_t>> chunk_offsets;
+    std::vector<std::vector<char>> chunks;
+};
+
+// Copies the part of `slab` covered by the chunk at `chunk_offset` into `chunk`,
+// which holds a whole chunk and is already filled with the fill value.
+inline void extract_chunk(const RepackSlab& slab,
+                          const std::vector<hsize_t>& chunk_offset,
+                          const std::vector<hsize_t>& chunk_dims,
+                          size_t element_size,
+                          std::vector<char>& chunk) {
+    const size_t n_dims = chunk_dims.size();
+    std::vector<hsize_t> count(n_dims);
+    for (size_t d = 0; d < n_dims; ++d) {
+        const hsize_t begin = chunk_offset[d] - slab.offset[d];
+        count[d] = std::min(chunk_dims[d], slab.count[d] - begin);
+    }
+
+    // Copy one run along the last dimension at a time.
+    const size_t run_size = count[n_dims - 1] * element_size;
+    std::vector<hsize_t> index(n_dims, 0);
+    while (true) {
+        size_t src = 0, dst = 0;
+        for (size_t d = 0; d < n_dims; ++d) {
+            src = src * slab.count[d] + (chunk_offset[d] - slab.offset[d] + index[d]);
+            dst = dst * chunk_dims[d] + index[d];
+        }
+        std::memcpy(chunk.data() + dst * element_size,
+                    slab.data.data() + src * element_size,
+                    run_size);
+
+        size_t d = n_dims - 1;
+        while (d-- > 0) {
+            if (++index[d] < count[d]) {
+                break;
+            }
+            index[d] = 0;
+        }
+        if (d == size_t(-1)) {
+            return;
+        }
+    }
+}
+
+// Repacks `src` into `dst`, whose chunks are filtered by `filters` only. The
+// calling thread reads slabs of `n_rows` rows and writes the compressed chunks
+// with `H5Dwrite_chunk`; `n_threads` threads compress the chunks of a slab
+// while the next slab is read.
+inline void repack_chunks_off_lock(const DataSet& src,
+                                   const DataSet& dst,
+                                   const DataType& dtype,
+                                   const std::vector<OffLockFilter>& filters,
+                                   const std::vector<hsize_t>& dims,
+                                   const std::vector<hsize_t>& chunk_dims,
+                                   hsize_t n_rows,
+                                   size_t n_threads) {
+    const size_t n_dims = dims.size();
+    const size_t element_size = dtype.getSize();
+
+    size_t chunk_size = element_size;
+    for (auto dim: chunk_dims) {
+        chunk_size *= dim;
+    }
+
+    // Chunks are stored whole, the part outside of the dataset holds the fill value.
+    std::vector<char> fill_chunk(chunk_size, 0);
+    {
+        auto dcpl = dst.getCreatePropertyList();
+        H5D_fill_value_t status;
+        std::vector<char> value(element_size, 0);
+        if (H5Pfill_value_defined(dcpl.getId(), &status) >= 0 &&
+            status != H5D_FILL_VALUE_UNDEFINED &&
+            H5Pget_fill_value(dcpl.getId(), dtype.getId(), value.data()) >= 0) {
+            for (size_t i = 0; i < chunk_size; i += element_size) {
+                std::copy(value.begin(), value.end(), fill_chunk.begin() + std::ptrdiff_t(i));
+            }
+        }
+    }
+
+    auto read_slab = [&](hsize_t row, RepackSlab& slab) {
+        slab.offset.assign(n_dims, 0);
+        slab.offset[0] = row;
+        slab.count = dims;
+        slab.count[0] = std::min(n_rows, dims[0] - row);
+
+        auto hyperslab = HyperSlab(RegularHyperSlab::fromHDF5Sizes(slab.offset, slab.count));
+        auto memspace = DataSpace(toSTLSizeVector(slab.count));
+        slab.data.resize(memspace.getElementCount() * element_size);
+        src.select(hyperslab, memspace).read(slab.data.data(), dtype);
+
+        // The chunks of the copy covering the slab, in row-major order.
+        slab.chunk_offsets.clear();
+        std::vector<hsize_t> offset = slab.offset;
+        while (true) {
+            slab.chunk_offsets.push_back(offset);
+
+            size_t d = n_dims;
+            while (d-- > 0) {
+                offset[d] += chunk_dims[d];
+                if (offset[d] < slab.offset[d] + slab.count[d]) {
+                    break;
+                }
+                offset[d] = slab.offset[d];
+            }
+            if (d == size_t(-1)) {
+                break;
+            }
+        }
+        slab.chunks.resize(slab.chunk_offsets.size());
+    };
+
+    std::vector<std::thread> workers;
+    std::exception_ptr error;
+    std::mutex error_mutex;
+    std::atomic<size_t> next_chunk{0};
+
+    auto compress_slab = [&](RepackSlab& slab) {
+        next_chunk = 0;
+        RepackSlab* slab_ptr = &slab;
+        for (size_t t = 0; t < n_threads; ++t) {
+            workers.emplace_back([&, slab_ptr]() {
+                auto& slab_ = *slab_ptr;
+                std::vector<char> scratch;
+                try {
+                    for (size_t i = next_chunk++; i < slab_.chunks.size(); i = next_chunk++) {
+                        auto& chunk = slab_.chunks[i];
+                        chunk = fill_chunk;
+                        extract_chunk(
+                            slab_, slab_.chunk_offsets[i], chunk_dims, element_size, chunk);
+                        apply_off_lock_filters(filters, chunk, scratch);
+                    }
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(error_mutex);
+                    if (!error) {
+                        error = std::current_exception();
+                    }
+                }
+            });
+        }
+    };
+
+    auto join_workers = [&]() {
+        for (auto& worker: workers) {
+            worker.join();
+        }
+        workers.clear();
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    };
+
+    RepackSlab current, next;
+    read_slab(0, current);
+    while (true) {
+        compress_slab(current);
+
+        const hsize_t next_row = current.offset[0] + current.count[0];
+        const bool has_next = next_row < dims[0];
+        try {
+            if (has_next) {
+                read_slab(next_row, next);
+            }
+        } catch (...) {
+            for (auto& worker: workers) {
+                worker.join();
+            }
+            throw;
+        }
+        join_workers();
+
+#if H5_VERSION_GE(1, 10, 2)
+        for (size_t i = 0; i < current.chunks.size(); ++i) {
+            const auto& chunk = current.chunks[i];
+            if (H5Dwrite_chunk(dst.getId(),
+                               H5P_DEFAULT,
+                               0,
+                               current.chunk_offsets[i].data(),
+                               chunk.size(),
+                               chunk.data()) < 0) {
+                HDF5ErrMapper::ToException<DataSetException>("Unable to write a chunk.");
+            }
+        }
+#endif
+
+        if (!has_next) {
+            break;
+        }
+        std::swap(current, next);
+    }
+}
+
+}  // namespace details
+
+}  // namespace HighFive
@@ -0,0 +1,654 @@
+/*
+ *  Copyright (c), 2023, Blue Brain Project - EPFL
+ *
+ *  Distributed under the Boost Software License, Version 1.0.
+ *    (See accompanying file LICENSE_1_0.txt or copy at
+ *          http://www.boost.org/LICENSE_1_0.txt)
+ *
+ */
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <H5Fpublic.h>
+#include <H5Ipublic.h>
+#include <H5Ppublic.h>
+
+#include "../H5Exception.hpp"
+#include "../H5Utility.hpp"
+#include "H5VirtualFileDriver_misc.hpp"
+
+namespace HighFive {
+
+namespace details {
+namespace block_cache {
+
+constexpr uint64_t segment_magic = 0x3148434b4c424648ull;  // "HFBLKCH1"
+constexpr int64_t none = -1;
+constexpr size_t max_name = 255;
+
+// The properties of the driver, stored in the file access property list.
+struct Config {
+    char name[max_name + 1];
+    uint64_t capacity;
+    uint64_t block_size;
+};
+
+// Identifies a block of a file. The size and modification time of the file
+// invalidate the blocks of files which are replaced or modified.
+struct Key {
+    uint64_t dev;
+    uint64_t ino;
+    uint64_t size;
+    uint64_t mtime;
+    uint64_t block;
+};
+
+inline bool operator==(const Key& a, const Key& b) {
+    return a.dev == b.dev && a.ino == b.ino && a.size == b.size && a.mtime == b.mtime &&
+           a.block == b.block;
+}
+
+inline uint64_t hash(const Key& key) {
+    uint64_t h = 0xCBF29CE484222325ull;
+    for (uint64_t value: {key.dev, key.ino, key.size, key.mtime, key.block}) {
+        h = (h ^ value) * 0x100000001B3ull;
+        h ^= h >> 29;
+    }
+    return h;
+}
+
+// The segment starts with the header, followed by the hash buckets, the
+// slots and the data of the blocks. The counters and lists are protected by
+// the mutex.
+struct Header {
+    std::atomic<uint64_t> magic;
+    uint64_t size;
+    uint64_t block_size;
+    uint64_t n_blocks;
+    uint64_t n_buckets;
+
+    pthread_mutex_t mutex;
+
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t evictions;
+    uint64_t n_used;
+
+    // Least recently used last.
+    int64_t lru_head;
+    int64_t lru_tail;
+    int64_t free_head;
+};
+
+struct Slot {
+    Key key;
+    int64_t prev;
+    int64_t next;
+    // The next slot in the same hash bucket.
+    int64_t chain;
+};
+
+struct Layout {
+    size_t buckets;
+    size_t slots;
+    size_t data;
+    size_t size;
+};
+
+inline Layout make_layout(uint64_t n_blocks, uint64_t n_buckets, uint64_t block_size) {
+    auto align = [](size_t offset, size_t alignment) {
+        return (offset + alignment - 1) / alignment * alignment;
+    };
+    Layout layout;
+    layout.buckets = align(sizeof(Header), 64);
+    layout.slots = align(layout.buckets + n_buckets * sizeof(int64_t), 64);
+    layout.data = align(layout.slots + n_blocks * sizeof(Slot), 4096);
+    layout.size = layout.data + n_blocks * block_size;
+    return layout;
+}
+
+// The mapping of a shared memory segment holding a cache.
+class Segment {
+  public:
+    explicit Segment(const Config& config);
+
+    size_t blockSize() const noexcept {
+        return _header->block_size;
+    }
+
+    // Copies `size` bytes at `offset` of the block `key` to `dst`, if it's cached.
+    bool copy(const Key& key, size_t offset, size_t size, char* dst);
+
+    // Inserts the block `key`, evicting the least recently used block if needed.
+    void insert(const Key& key, const char* block);
+
+    BlockCacheStats stats();
+    void resetStats();
+
+  private:
+    class Lock {
+      public:
+        explicit Lock(Segment& segment);
+        ~Lock() {
+            pthread_mutex_unlock(&_segment._header->mutex);
+        }
+
+      private:
+        Segment& _segment;
+    };
+
+    void _map(int fd, size_t size);
+    void _clear() noexcept;
+    int64_t _find(const Key& key) const noexcept;
+    void _unlinkLRU(int64_t i) noexcept;
+    void _pushFront(int64_t i) noexcept;
+    void _unlinkBucket(int64_t i) noexcept;
+
+    std::string _name;
+    Header* _header = nullptr;
+    int64_t* _buckets = nullptr;
+    Slot* _slots = nullptr;
+    char* _data = nullptr;
+};
+
+inline Segment::Lock::Lock(Segment& segment)
+    : _segment(segment) {
+    const int status = pthread_mutex_lock(&_segment._header->mutex);
+    if (status == EOWNERDEAD) {
+        // A process died while holding the lock, the lists might be corrupt.
+        _segment._clear();
+        pthread_mutex_consistent(&_segment._header->mutex);
+    } else if (status != 0) {
+        throw FileException("SharedBlockCache: unable to lock " + _segment._name);
+    }
+}
+
+inline Segment::Segment(const Config& config)
+    : _name(config.name) {
+    int fd = shm_open(_name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd >= 0) {
+        const uint64_t block_size = config.block_size;
+        const uint64_t n_blocks = std::max(uint64_t(1), config.capacity / block_size);
+        const uint64_t n_buckets = 2 * n_blocks;
+        const auto layout = make_layout(n_blocks, n_buckets, block_size);
+
+        if (ftruncate(fd, off_t(layout.size)) != 0) {
+            ::close(fd);
+            shm_unlink(_name.c_str());
+            throw FileException("SharedBlockCache: unable to allocate " + _name);
+        }
+        try {
+            _map(fd, layout.size);
+        } catch (...) {
+            // Otherwise the other processes wait for it to be initialized.
+            shm_unlink(_name.c_str());
+            throw;
+        }
+
+        _header = new (_header) Header();
+        _header->size = layout.size;
+        _header->block_size = block_size;
+        _header->n_blocks = n_blocks;
+        _header->n_buckets = n_buckets;
+        _buckets = reinterpret_cast<int64_t*>(reinterpret_cast<char*>(_header) + layout.buckets);
+        _slots = reinterpret_cast<Slot*>(reinterpret_cast<char*>(_header) + layout.slots);
+        _data = reinterpret_cast<char*>(_header) + layout.data;
+
+        pthread_mutexattr_t attr;
+        pthread_mutexattr_init(&attr);
+        pthread_mutexattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+        pthread_mutexattr_setrobust(&attr, PTHREAD_MUTEX_ROBUST);
+        pthread_mutex_init(&_header->mutex, &attr);
+        pthread_mutexattr_destroy(&attr);
+
+        _clear();
+        _header->magic.store(segment_magic, std::memory_order_release);
+        return;
+    }
+
+    if (errno != EEXIST || (fd = shm_open(_name.c_str(), O_RDWR, 0)) < 0) {
+        throw FileException("SharedBlockCache: unable to open " + _name);
+    }
+
+    // Wait for the process which created the segment to initialize it.
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    size_t size = 0;
+    while (size == 0) {
+        struct stat status;
+        if (fstat(fd, &status) == 0 && size_t(status.st_size) >= sizeof(Header)) {
+            void* ptr = mmap(nullptr, sizeof(Header), PROT_READ, MAP_SHARED, fd, 0);
+            if (ptr != MAP_FAILED) {
+                const auto* header = static_cast<const Header*>(ptr);
+                if (header->magic.load(std::memory_order_acquire) == segment_magic) {
+                    size = header->size;
+                }
+                munmap(ptr, sizeof(Header));
+            }
+        }
+        if (size == 0) {
+            if (std::chrono::steady_clock::now() > deadline) {
+                ::close(fd);
+                throw FileException("SharedBlockCache: " + _name +
+                                    " was never initialized, remove it and retry.");
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+    _map(fd, size);
+
+    const auto layout = make_layout(_header->n_blocks, _header->n_buckets, _header->block_size);
+    _buckets = reinterpret_cast<int64_t*>(reinterpret_cast<char*>(_header) + layout.buckets);
+    _slots = reinterpret_cast<Slot*>(reinterpret_cast<char*>(_header) + layout.slots);
+    _data = reinterpret_cast<char*>(_header) + layout.data;
+}
+
+inline void Segment::_map(int fd, size_t size) {
+    void* ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (ptr == MAP_FAILED) {
+        throw FileException("SharedBlockCache: unable to map " + _name);
+    }
+    _header = static_cast<Header*>(ptr);
+}
+
+inline void Segment::_clear() noexcept {
+    std::fill(_buckets, _buckets + _header->n_buckets, none);
+    for (uint64_t i = 0; i < _header->n_blocks; ++i) {
+        _slots[i].next = i + 1 < _header->n_blocks ? int64_t(i + 1) : none;
+    }
+    _header->free_head = 0;
+    _header->lru_head = none;
+    _header->lru_tail = none;
+    _header->n_used = 0;
+}
+
+inline int64_t Segment::_find(const Key& key) const noexcept {
+    int64_t i = _buckets[hash(key) % _header->n_buckets];
+    while (i != none && !(_slots[i].key == key)) {
+        i = _slots[i].chain;
+    }
+    return i;
+}
+
+inline void Segment::_unlinkLRU(int64_t i) noexcept {
+    auto& slot = _slots[i];
+    (slot.prev == none ? _header->lru_head : _slots[slot.prev].next) = slot.next;
+    (slot.next == none ? _header->lru_tail : _slots[slot.next].prev) = slot.prev;
+}
+
+inline void Segment::_pushFront(int64_t i) noexcept {
+    _slots[i].prev = none;
+    _slots[i].next = _header->lru_head;
+    (_header->lru_head == none ? _header->lru_tail : _slots[_header->lru_head].prev) = i;
+    _header->lru_head = i;
+}
+
+inline void Segment::_unlinkBucket(int64_t i) noexcept {
+    int64_t* link = &_buckets[hash(_slots[i].key) % _header->n_buckets];
+    while (*link != i) {
+        link = &_slots[*link].chain;
+    }
+    *link = _slots[i].chain;
+}
+
+inline bool Segment::copy(const Key& key, size_t offset, size_t size, char* dst) {
+    Lock lock(*this);
+    const int64_t i = _find(key);
+    if (i == none) {
+        ++_header->misses;
+        return false;
+    }
+
+    ++_header->hits;
+    _unlinkLRU(i);
+    _pushFront(i);
+    std::memcpy(dst, _data + size_t(i) * _header->block_size + offset, size);
+    return true;
+}
+
+inline void Segment::insert(const Key& key, const char* block) {
+    Lock lock(*this);
+    if (_find(key) != none) {
+        // Read by another process in the meantime.
+        return;
+    }
+
+    int64_t i = _header->free_head;
+    if (i != none) {
+        _header->free_head = _slots[i].next;
+        ++_header->n_used;
+    } else {
+        i = _header->lru_tail;
+        _unlinkLRU(i);
+        _unlinkBucket(i);
+        ++_header->evictions;
+    }
+
+    auto& bucket = _buckets[hash(key) % _header->n_buckets];
+    _slots[i].key = key;
+    _slots[i].chain = bucket;
+    bucket = i;
+    _pushFront(i);
+    std::memcpy(_data + size_t(i) * _header->block_size, block, _header->block_size);
+}
+
+inline BlockCacheStats Segment::stats() {
+    Lock lock(*this);
+    BlockCacheStats stats;
+    stats.hits = _header->hits;
+    stats.misses = _header->misses;
+    stats.evictions = _header->evictions;
+    stats.n_blocks = _header->n_used;
+    stats.max_blocks = _header->n_blocks;
+    stats.block_size = _header->block_size;
+    return stats;
+}
+
+inline void Segment::resetStats() {
+    Lock lock(*this);
+    _header->hits = 0;
+    _header->misses = 0;
+    _header->evictions = 0;
+}
+
+// The segments stay mapped for the lifetime of the process, files which are
+// still open when it exits, or when their segment is removed, use them.
+struct SegmentRegistry {
+    std::mutex mutex;
+    std::map<std::string, std::unique_ptr<Segment>> segments;
+    std::vector<std::unique_ptr<Segment>> removed;
+};
+
+inline SegmentRegistry& segment_registry() {
+    static auto* registry = new SegmentRegistry();
+    return *registry;
+}
+
+inline Segment& attach_segment(const Config& config) {
+    auto& registry = segment_registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    auto& segment = registry.segments[config.name];
+    if (segment == nullptr) {
+        segment.reset(new Segment(config));
+    }
+    return *segment;
+}
+
+inline void detach_segment(const std::string& name) {
+    auto& registry = segment_registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    auto it = registry.segments.find(name);
+    if (it != registry.segments.end()) {
+        registry.removed.push_back(std::move(it->second));
+        registry.segments.erase(it);
+    }
+}
+
+inline Config make_config(const std::string& name, size_t capacity, size_t block_size) {
+    Config config;
+    std::memset(&config, 0, sizeof(config));
+    std::strncpy(config.name, name.c_str(), max_name);
+    config.capacity = capacity;
+    config.block_size = block_size;
+    return config;
+}
+
+// Reads `size` bytes at `offset`, or up to the end of the file.
+inline void read_fully(int fd, uint64_t offset, size_t size, char* dst) {
+    while (size > 0) {
+        const ssize_t n = ::pread(fd, dst, size, off_t(offset));
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n < 0) {
+            throw FileException("SharedBlockCache: unable to read the file.");
+        }
+        if (n == 0) {
+            return;
+        }
+        dst += n;
+        offset += uint64_t(n);
+        size -= size_t(n);
+    }
+}
+
+// The file driver. `pub` must be first, HDF5 only knows about it.
+struct DriverFile {
+    H5FD_t pub;
+    int fd;
+    haddr_t eoa;
+    haddr_t eof;
+    Key key;
+    Config config;
+    Segment* segment;
+};
+
+inline H5FD_t* open(const char* name, unsigned flags, hid_t fapl, haddr_t) noexcept {
+    try {
+        if (flags & (H5F_ACC_RDWR | H5F_ACC_TRUNC | H5F_ACC_CREAT | H5F_ACC_EXCL)) {
+            HIGHFIVE_LOG_ERROR("SharedBlockCache: can't open " + std::string(name) +
+                               " for writing, only read-only files are supported.");
+            return nullptr;
+        }
+
+        const auto* config = static_cast<const Config*>(H5Pget_driver_info(fapl));
+        if (config == nullptr) {
+            return nullptr;
+        }
+
+        std::unique_ptr<DriverFile> file(new DriverFile());
+        file->fd = ::open(name, O_RDONLY);
+        if (file->fd < 0) {
+            return nullptr;
+        }
+
+        struct stat status;
+        if (fstat(file->fd, &status) != 0) {
+            ::close(file->fd);
+            return nullptr;
+        }
+        file->key.dev = uint64_t(status.st_dev);
+        file->key.ino = uint64_t(status.st_ino);
+        file->key.size = uint64_t(status.st_size);
+        file->key.mtime = uint64_t(status.st_mtim.tv_sec) * 1000000000ull +
+                          uint64_t(status.st_mtim.tv_nsec);
+        file->eof = haddr_t(status.st_size);
+        file->config = *config;
+
+        try {
+            file->segment = &attach_segment(*config);
+        } catch (...) {
+            ::close(file->fd);
+            throw;
+        }
+        return &file.release()->pub;
+    } catch (const std::exception& e) {
+        HIGHFIVE_LOG_ERROR(e.what());
+    } catch (...) {
+    }
+    return nullptr;
+}
+
+inline herr_t close(H5FD_t* _file) noexcept {
+    auto* file = reinterpret_cast<DriverFile*>(_file);
+    const int status = ::close(file->fd);
+    delete file;
+    return status == 0 ? 0 : -1;
+}
+
+inline int cmp(const H5FD_t* _a, const H5FD_t* _b) noexcept {
+    const auto& a = reinterpret_cast<const DriverFile*>(_a)->key;
+    const auto& b = reinterpret_cast<const DriverFile*>(_b)->key;
+    if (a.dev != b.dev) {
+        return a.dev < b.dev ? -1 : 1;
+    }
+    if (a.ino != b.ino) {
+        return a.ino < b.ino ? -1 : 1;
+    }
+    return 0;
+}
+
+inline herr_t query(const H5FD_t*, unsigned long* flags) noexcept {
+    if (flags != nullptr) {
+        *flags = H5FD_FEAT_AGGREGATE_METADATA | H5FD_FEAT_ACCUMULATE_METADATA |
+                 H5FD_FEAT_DATA_SIEVE | H5FD_FEAT_AGGREGATE_SMALLDATA;
+    }
+    return 0;
+}
+
+inline herr_t read(
+    H5FD_t* _file, H5FD_mem_t, hid_t, haddr_t addr, size_t size, void* buffer) noexcept {
+    auto* file = reinterpret_cast<DriverFile*>(_file);
+    if (addr == HADDR_UNDEF || addr + size < addr || addr + size > file->eoa) {
+        return -1;
+    }
+
+    try {
+        auto& segment = *file->segment;
+        const size_t block_size = segment.blockSize();
+        std::vector<char> block;
+
+        auto key = file->key;
+        char* dst = static_cast<char*>(buffer);
+        while (size > 0) {
+            key.block = addr / block_size;
+            const size_t offset = addr % block_size;
+            const size_t n = std::min(size, block_size - offset);
+
+            if (!segment.copy(key, offset, n, dst)) {
+                // Past the end of the file, blocks are filled with zeros.
+                const haddr_t begin = key.block * block_size;
+                block.assign(block_size, 0);
+                if (begin < file->eof) {
+                    read_fully(file->fd,
+                               begin,
+                               size_t(std::min(haddr_t(block_size), file->eof - begin)),
+                               block.data());
+                }
+                segment.insert(key, block.data());
+                std::memcpy(dst, block.data() + offset, n);
+            }
+
+            addr += n;
+            dst += n;
+            size -= n;
+        }
+        return 0;
+    } catch (const std::exception& e) {
+        HIGHFIVE_LOG_ERROR(e.what());
+    } catch (...) {
+    }
+    return -1;
+}
+
+inline herr_t write(H5FD_t*, H5FD_mem_t, hid_t, haddr_t, size_t, const void*) noexcept {
+    return -1;
+}
+
+inline H5FD_class_t make_driver_class() {
+    // From the range reserved for drivers which aren't registered with The HDF Group.
+    auto cls = vfd::make_class<DriverFile>("highfive_shared_block_cache", 511);
+    cls.open = open;
+    cls.close = close;
+    cls.cmp = cmp;
+    cls.query = query;
+    cls.read = read;
+    cls.write = write;
+    return cls;
+}
+
+inline hid_t driver_id() {
+    return vfd::driver_id<make_driver_class>();
+}
+
+}  // namespace block_cache
+}  // namespace details
+
+inline SharedBlockCache::SharedBlockCache(const std::string& name,
+                                          size_t capacity,
+                                          size_t block_size)
+    : _name(name)
+    , _capacity(capacity)
+    , _block_size(block_size) {
+    if (name.size() < 2 || name.size() > details::block_cache::max_name || name[0] != '/' ||
+        name.find('/', 1) != std::string::npos) {
+        throw PropertyException("SharedBlockCache: invalid name '" + name +
+                                "', expected e.g. '/my_cache'.");
+    }
+    if (block_size == 0 || capacity < block_size) {
+        throw PropertyException("SharedBlockCache: the capacity must hold at least one block.");
+    }
+}
+
+inline SharedBlockCache::SharedBlockCache(const FileAccessProps& fapl) {
+    if (H5Pget_driver(fapl.getId()) != details::block_cache::driver_id()) {
+        throw PropertyException("The file access properties don't use a SharedBlockCache.");
+    }
+    const auto* config =
+        static_cast<const details::block_cache::Config*>(H5Pget_driver_info(fapl.getId()));
+    if (config == nullptr) {
+        HDF5ErrMapper::ToException<PropertyException>(
+            "Unable to access the SharedBlockCache properties");
+    }
+    _name = config->name;
+    _capacity = config->capacity;
+    _block_size = config->block_size;
+}
+
+inline const std::string& SharedBlockCache::getName() const noexcept {
+    return _name;
+}
+
+inline size_t SharedBlockCache::getCapacity() const noexcept {
+    return _capacity;
+}
+
+inline size_t SharedBlockCache::getBlockSize() const noexcept {
+    return _block_size;
+}
+
+inline BlockCacheStats SharedBlockCache::getStats() const {
+    return details::block_cache::attach_segment(
+               details::block_cache::make_config(_name, _capacity, _block_size))
+        .stats();
+}
+
+inline void SharedBlockCache::resetStats() const {
+    details::block_cache::attach_segment(
+        details::block_cache::make_config(_name, _capacity, _block_size))
+        .resetStats();
+}
+
+inline void SharedBlockCache::remove(const std::string& name) {
+    if (shm_unlink(name.c_str()) != 0 && errno != ENOENT) {
+        throw FileException("SharedBlockCache: unable to remove " + name);
+    }
+    details::block_cache::detach_segment(name);
+}
+
+inline void SharedBlockCache::apply(const hid_t list) const {
+    const auto config = details::block_cache::make_config(_name, _capacity, _block_size);
+    if (H5Pset_driver(list, details::block_cache::driver_id(), &config) < 0) {
+        HDF5ErrMapper::ToException<PropertyException>("Error setting the SharedBlockCache driver");
+    }
+}
+
+}  // namespace HighFive
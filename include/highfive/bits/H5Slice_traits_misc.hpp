@@ -20,6 +20,8 @@
 
 #include "H5ReadWrite_misc.hpp"
 #include "H5Converter_misc.hpp"
+#include "../H5IOTrace.hpp"
+#include "../H5Utility.hpp"
 
 namespace HighFive {
 
@@ -46,6 +48,22 @@ inline hid_t get_memspace_id(const Selection& ptr) {
 inline hid_t get_memspace_id(const DataSet&) {
     return H5S_ALL;
 }
+
+#ifdef H5_HAVE_DIRECT
+// Direct I/O silently copies misaligned buffers through a bounce buffer.
+inline void warn_if_misaligned_for_direct_io(const DataSet& dataset,
+                                             size_t alignment,
+                                             const void* buffer) {
+    if (alignment > 0 && reinterpret_cast<std::uintptr_t>(buffer) % alignment != 0) {
+        // Writing in a loop would warn on every call.
+        HIGHFIVE_LOG_WARN_LIMITED(1,
+                                  "Buffer written to '" + dataset.getPath() +
+                                      "' isn't aligned to " + std::to_string(alignment) +
+                                      " bytes, direct I/O requires copying it. Consider "
+                                      "using an `AlignedAllocator`.");
+    }
+}
+#endif
 }  // namespace details
 
 inline ElementSet::ElementSet(std::initializer_list<std::size_t> list)
@@ -220,15 +238,19 @@ inline void SliceTraits<Derivate>::read(T* array,
                   "read() requires a non-const structure to read data into");
 
     const auto& slice = static_cast<const Derivate&>(*this);
+    const auto& dataset = details::get_dataset(slice);
+    const auto file_space = slice.getSpace();
+    details::IOTraceScope trace(IOTrace::Operation::Read, dataset.getId(), file_space.getId());
 
-    if (H5Dread(details::get_dataset(slice).getId(),
+    if (H5Dread(dataset.getId(),
                 mem_datatype.getId(),
                 details::get_memspace_id(slice),
-                slice.getSpace().getId(),
+                file_space.getId(),
                 xfer_props.getId(),
                 static_cast<void*>(array)) < 0) {
         HDF5ErrMapper::ToException<DataSetException>("Error during HDF5 Read.");
     }
+    trace.succeeded();
 }
 
 template <typename Derivate>
@@ -274,15 +296,28 @@ inline void SliceTraits<Derivate>::write_raw(const T* buffer,
                                              const DataType& mem_datatype,
                                              const DataTransferProps& xfer_props) {
     const auto& slice = static_cast<const Derivate&>(*this);
+    const auto& dataset = details::get_dataset(slice);
+
+#ifdef H5_HAVE_DIRECT
+    if (dataset.isValid()) {
+        details::warn_if_misaligned_for_direct_io(dataset,
+                                                  dataset._getDirectIOAlignment(),
+                                                  buffer);
+    }
+#endif
+
+    const auto file_space = slice.getSpace();
+    details::IOTraceScope trace(IOTrace::Operation::Write, dataset.getId(), file_space.getId());
 
-    if (H5Dwrite(details::get_dataset(slice).getId(),
+    if (H5Dwrite(dataset.getId(),
                  mem_datatype.getId(),
                  details::get_memspace_id(slice),
-                 slice.getSpace().getId(),
+                 file_space.getId(),
                  xfer_props.getId(),
                  static_cast<const void*>(buffer)) < 0) {
         HDF5ErrMapper::ToException<DataSetException>("Error during HDF5 Write: ");
     }
+    trace.succeeded();
 }
 
 template <typename Derivate>
@@ -0,0 +1,246 @@
+/*
+ *  Copyright (c), 2023, Blue Brain Project - EPFL
+ *
+ *  Distributed under the Boost Software License, Version 1.0.
+ *    (See accompanying file LICENSE_1_0.txt or copy at
+ *          http://www.boost.org/LICENSE_1_0.txt)
+ *
+ */
+#pragma once
+
+#include <array>
+#include <cstdio>
+
+namespace HighFive {
+
+namespace details {
+
+struct TimelineEvent {
+    const char* name = nullptr;
+    std::string detail;
+    /// Nanoseconds since the epoch of `steady_clock`.
+    uint64_t start = 0;
+    uint64_t duration = 0;
+};
+
+// The events of a thread are stored in a list of blocks. Only the thread
+// appends to its last block and publishes the events with `size`; a block is
+// never written again once `next` is set, hence `stop` can read and free it.
+struct TimelineBlock {
+    static constexpr size_t capacity = 256;
+
+    std::array<TimelineEvent, capacity> events;
+    std::atomic<size_t> size{0};
+    std::atomic<TimelineBlock*> next{nullptr};
+};
+
+struct TimelineBuffer {
+    explicit TimelineBuffer(uint32_t tid_)
+        : tid(tid_)
+        , head(new TimelineBlock())
+        , tail(head) {}
+
+    TimelineBuffer(const TimelineBuffer&) = delete;
+    TimelineBuffer& operator=(const TimelineBuffer&) = delete;
+
+    ~TimelineBuffer() {
+        while (head != nullptr) {
+            auto next = head->next.load(std::memory_order_acquire);
+            delete head;
+            head = next;
+        }
+    }
+
+    uint32_t tid;
+    /// Set when the thread exits, the buffer can be freed once read.
+    std::atomic<bool> finished{false};
+
+    // Owned by `Timeline::stop`, under the lock of the state.
+    TimelineBlock* head;
+    size_t n_read = 0;
+
+    // Owned by the thread.
+    TimelineBlock* tail;
+};
+
+struct TimelineState {
+    std::atomic<bool> active{false};
+    std::mutex mutex;
+    std::vector<std::unique_ptr<TimelineBuffer>> buffers;
+    uint32_t next_tid = 0;
+    std::ofstream out;
+    uint64_t origin = 0;
+};
+
+inline TimelineState& get_timeline_state() {
+    static TimelineState state;
+    return state;
+}
+
+inline uint64_t timeline_nanoseconds(std::chrono::steady_clock::time_point t) {
+    using std::chrono::duration_cast;
+    using std::chrono::nanoseconds;
+    return static_cast<uint64_t>(duration_cast<nanoseconds>(t.time_since_epoch()).count());
+}
+
+// Marks the buffer of the thread as finished when the thread exits.
+struct TimelineThread {
+    TimelineBuffer* buffer = nullptr;
+
+    ~TimelineThread() {
+        if (buffer != nullptr) {
+            buffer->finished.store(true, std::memory_order_release);
+        }
+    }
+};
+
+// The buffer of the calling thread, registered on first use.
+inline TimelineBuffer& get_timeline_buffer() {
+    auto& state = get_timeline_state();
+    static thread_local TimelineThread thread;
+    if (thread.buffer == nullptr) {
+        std::lock_guard<std::mutex> lock(state.mutex);
+        state.buffers.emplace_back(new TimelineBuffer(state.next_tid++));
+        thread.buffer = state.buffers.back().get();
+    }
+    return *thread.buffer;
+}
+
+inline void write_json_string(std::ostream& out, const char* str, size_t length) {
+    out << '"';
+    for (size_t i = 0; i < length; ++i) {
+        const char c = str[i];
+        if (c == '"' || c == '\\') {
+            out << '\\' << c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            char escaped[8];
+            std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned>(c));
+            out << escaped;
+        } else {
+            out << c;
+        }
+    }
+    out << '"';
+}
+
+inline void write_timeline_event(std::ostream& out,
+                                 const TimelineEvent& event,
+                                 uint32_t tid,
+                                 uint64_t origin) {
+    out << "{\"name\":";
+    write_json_string(out, event.name, std::char_traits<char>::length(event.name));
+    out << ",\"cat\":\"HighFive\",\"ph\":\"X\",\"ts\":" << double(event.start - origin) / 1000.0
+        << ",\"dur\":" << double(event.duration) / 1000.0 << ",\"pid\":0,\"tid\":" << tid;
+    if (!event.detail.empty()) {
+        out << ",\"args\":{\"name\":";
+        write_json_string(out, event.detail.data(), event.detail.size());
+        out << '}';
+    }
+    out << '}';
+}
+
+// Writes the unread events of `buffer` which started after `origin`, and
+// frees the blocks which won't be written again.
+inline void drain_timeline_buffer(std::ostream& out,
+                                  TimelineBuffer& buffer,
+                                  uint64_t origin,
+                                  bool& first) {
+    while (true) {
+        auto block = buffer.head;
+        const size_t size = block->size.load(std::memory_order_acquire);
+        for (size_t i = buffer.n_read; i < size; ++i) {
+            const auto& event = block->events[i];
+            if (event.start >= origin) {
+                out << (first ? "\n" : ",\n");
+                write_timeline_event(out, event, buffer.tid, origin);
+                first = false;
+            }
+        }
+        buffer.n_read = size;
+
+        auto next = size == TimelineBlock::capacity ? block->next.load(std::memory_order_acquire)
+                                                    : nullptr;
+        if (next == nullptr) {
+            return;
+        }
+        buffer.head = next;
+        buffer.n_read = 0;
+        delete block;
+    }
+}
+
+}  // namespace details
+
+inline void Timeline::start(const std::string& filename) {
+    stop();
+
+    auto& state = details::get_timeline_state();
+    std::lock_guard<std::mutex> lock(state.mutex);
+
+    state.out.open(filename, std::ios::trunc);
+    if (!state.out) {
+        throw Exception("Timeline: unable to open " + filename);
+    }
+    state.origin = details::timeline_nanoseconds(std::chrono::steady_clock::now());
+    state.active = true;
+}
+
+inline void Timeline::stop() {
+    auto& state = details::get_timeline_state();
+    std::lock_guard<std::mutex> lock(state.mutex);
+
+    state.active = false;
+    if (!state.out.is_open()) {
+        return;
+    }
+
+    auto& out = state.out;
+    out.setf(std::ios::fixed);
+    out.precision(3);
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    auto& buffers = state.buffers;
+    for (auto it = buffers.begin(); it != buffers.end();) {
+        // Read `finished` first: once set, no event can follow.
+        const bool finished = (*it)->finished.load(std::memory_order_acquire);
+        details::drain_timeline_buffer(out, **it, state.origin, first);
+        it = finished ? buffers.erase(it) : it + 1;
+    }
+    out << "\n]}\n";
+    out.close();
+    if (!out) {
+        throw Exception("Timeline: unable to write the timeline.");
+    }
+}
+
+inline bool Timeline::isActive() noexcept {
+    return details::get_timeline_state().active.load(std::memory_order_relaxed);
+}
+
+inline void Timeline::record(const char* name,
+                             const std::string& detail,
+                             std::chrono::steady_clock::time_point start,
+                             std::chrono::steady_clock::time_point stop) noexcept {
+    try {
+        auto& buffer = details::get_timeline_buffer();
+        auto block = buffer.tail;
+        size_t size = block->size.load(std::memory_order_relaxed);
+        if (size == details::TimelineBlock::capacity) {
+            auto next = new details::TimelineBlock();
+            block->next.store(next, std::memory_order_release);
+            buffer.tail = block = next;
+            size = 0;
+        }
+
+        auto& event = block->events[size];
+        event.name = name;
+        event.detail = detail;
+        event.start = details::timeline_nanoseconds(start);
+        event.duration = details::timeline_nanoseconds(stop) - event.start;
+        block->size.store(size + 1, std::memory_order_release);
+    } catch (...) {
+        // The timeline must never break the traced application.
+    }
+}
+
+}  // namespace HighFive
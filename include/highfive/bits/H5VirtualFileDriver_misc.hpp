@@ -0,0 +1,131 @@
+/*
+ *  Copyright (c), 2023, Blue Brain Project - EPFL
+ *
+ *  Distributed under the Boost Software License, Version 1.0.
+ *    (See accompanying file LICENSE_1_0.txt or copy at
+ *          http://www.boost.org/LICENSE_1_0.txt)
+ *
+ */
+#pragma once
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+#include <mutex>
+#include <string>
+
+#include <sys/types.h>
+
+#include <H5FDpublic.h>
+#include <H5Ipublic.h>
+#if H5_VERSION_GE(1, 13, 0)
+#include <H5FDdevelop.h>
+#endif
+
+#include "../H5Exception.hpp"
+
+namespace HighFive {
+
+namespace details {
+
+// The parts shared by the file drivers of HighFive.
+//
+// `File` is the state of a file opened by a driver. Its first member is the
+// `H5FD_t`, the only part HDF5 knows about, followed by at least the members
+// `config`, the properties of the driver, `fd`, `eoa` and `eof`.
+namespace vfd {
+
+template <typename Config>
+inline void* fapl_copy(const void* fapl) noexcept {
+    void* copy = std::malloc(sizeof(Config));
+    if (copy != nullptr) {
+        std::memcpy(copy, fapl, sizeof(Config));
+    }
+    return copy;
+}
+
+inline herr_t fapl_free(void* fapl) noexcept {
+    std::free(fapl);
+    return 0;
+}
+
+template <typename File>
+inline void* fapl_get(H5FD_t* file) noexcept {
+    return fapl_copy<decltype(File::config)>(&reinterpret_cast<File*>(file)->config);
+}
+
+template <typename File>
+inline haddr_t get_eoa(const H5FD_t* file, H5FD_mem_t) noexcept {
+    return reinterpret_cast<const File*>(file)->eoa;
+}
+
+template <typename File>
+inline herr_t set_eoa(H5FD_t* file, H5FD_mem_t, haddr_t addr) noexcept {
+    reinterpret_cast<File*>(file)->eoa = addr;
+    return 0;
+}
+
+template <typename File>
+inline haddr_t get_eof(const H5FD_t* file, H5FD_mem_t) noexcept {
+    return reinterpret_cast<const File*>(file)->eof;
+}
+
+template <typename File>
+inline herr_t get_handle(H5FD_t* file, hid_t, void** handle) noexcept {
+    *handle = &reinterpret_cast<File*>(file)->fd;
+    return 0;
+}
+
+// The class of a driver with the callbacks above. `value` identifies the
+// driver from HDF5 1.14 on, drivers which aren't registered with The HDF Group
+// use values from 256 to 511.
+template <typename File>
+inline H5FD_class_t make_class(const char* name, int value) {
+    H5FD_class_t cls;
+    std::memset(&cls, 0, sizeof(cls));
+#if H5_VERSION_GE(1, 14, 0)
+    cls.version = H5FD_CLASS_VERSION;
+    cls.value = value;
+#else
+    (void) value;
+#endif
+    cls.name = name;
+    cls.maxaddr = (haddr_t(1) << (8 * sizeof(off_t) - 1)) - 1;
+    cls.fc_degree = H5F_CLOSE_WEAK;
+    cls.fapl_size = sizeof(File::config);
+    cls.fapl_get = fapl_get<File>;
+    cls.fapl_copy = fapl_copy<decltype(File::config)>;
+    cls.fapl_free = fapl_free;
+    cls.get_eoa = get_eoa<File>;
+    cls.set_eoa = set_eoa<File>;
+    cls.get_eof = get_eof<File>;
+    cls.get_handle = get_handle<File>;
+
+    const H5FD_mem_t fl_map[] = H5FD_FLMAP_DICHOTOMY;
+    std::copy(std::begin(fl_map), std::end(fl_map), std::begin(cls.fl_map));
+    return cls;
+}
+
+// Registers the driver of class `make_driver_class()` on first use, and again
+// after the library was closed.
+template <H5FD_class_t (*make_driver_class)()>
+inline hid_t driver_id() {
+    static const H5FD_class_t cls = make_driver_class();
+    static std::mutex mutex;
+    static hid_t id = H5I_INVALID_HID;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (id < 0 || H5Iis_valid(id) <= 0) {
+        id = H5FDregister(&cls);
+        if (id < 0) {
+            HDF5ErrMapper::ToException<PropertyException>("Unable to register the file driver " +
+                                                          std::string(cls.name));
+        }
+    }
+    return id;
+}
+
+}  // namespace vfd
+}  // namespace details
+}  // namespace HighFive
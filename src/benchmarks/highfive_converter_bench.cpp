@@ -0,0 +1,80 @@
+// Measures the converter and inspector paths of HighFive, i.e. the copies
+// between nested containers and the contiguous buffers passed to HDF5, next to
+// the same amount of data in a flat vector.
+//
+// Usage: highfive_converter_bench [N_ROWS]
+//
+// Every case reports its wall-clock time and, around it, hardware counters
+// and resource usage, see `perf_counters.hpp`: bytes per cycle, instructions
+// per cycle, last level cache misses per MiB and page faults tell whether a
+// case is bound by copies, by cache misses or by the kernel. The file is kept
+// in memory with the core driver to exclude the storage.
+
+#include <highfive/H5DataSet.hpp>
+#include <highfive/H5File.hpp>
+
+#include <H5FDcore.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "perf_counters.hpp"
+
+using namespace HighFive;
+
+const size_t ROW_LENGTH = 10;
+
+// The in-memory driver, without backing store.
+struct CoreDriver {
+    void apply(hid_t list) const {
+        H5Pset_fapl_core(list, 64 * 1024 * 1024, 0);
+    }
+};
+
+template <typename F>
+void run(const std::string& name, size_t n_bytes, F f) {
+    PerfCounters counters;
+    counters.start();
+    auto start = std::chrono::steady_clock::now();
+    f();
+    auto stop = std::chrono::steady_clock::now();
+    auto sample = counters.stop();
+
+    std::cout << std::left << std::setw(22) << name << std::right << std::setw(10)
+              << std::fixed << std::setprecision(4)
+              << std::chrono::duration<double>(stop - start).count() << " s";
+    std::cout << std::defaultfloat << std::setprecision(3);
+    print_sample(std::cout, sample, n_bytes);
+    std::cout << "\n";
+}
+
+int main(int argc, char* argv[]) {
+    const size_t n_rows = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+    const size_t n_bytes = n_rows * ROW_LENGTH * sizeof(int);
+
+    const auto nested = std::vector<std::vector<int>>(n_rows, std::vector<int>(ROW_LENGTH, 1));
+    const auto flat = std::vector<int>(n_rows * ROW_LENGTH, 1);
+
+    FileAccessProps fapl;
+    fapl.add(CoreDriver());
+    File file("converter_bench.h5", File::Truncate, fapl);
+    auto dataset = file.createDataSet<int>("nested", DataSpace({n_rows, ROW_LENGTH}));
+    auto flat_dataset = file.createDataSet<int>("flat", DataSpace({n_rows * ROW_LENGTH}));
+
+    run("write nested vector", n_bytes, [&]() { dataset.write(nested); });
+    run("write flat vector", n_bytes, [&]() { flat_dataset.write(flat); });
+    run("write_raw", n_bytes, [&]() { flat_dataset.write_raw(flat.data()); });
+
+    std::vector<std::vector<int>> nested_result;
+    run("read nested vector", n_bytes, [&]() { dataset.read(nested_result); });
+
+    std::vector<int> flat_result;
+    run("read flat vector", n_bytes, [&]() { flat_dataset.read(flat_result); });
+    run("read raw", n_bytes, [&]() { flat_dataset.read(flat_result.data()); });
+
+    return nested_result == nested && flat_result == flat ? 0 : 1;
+}
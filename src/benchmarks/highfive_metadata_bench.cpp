@@ -0,0 +1,154 @@
+// Measures the throughput of metadata operations: creating, opening and
+// iterating over groups, datasets, attributes and references.
+//
+// Usage: highfive_metadata_bench [N...]
+//
+// Every operation is applied to N objects in a single group, by default for
+// N = 1000 and 10000. Pass other values of N to measure larger groups, e.g.
+// `highfive_metadata_bench 100000 1000000`.
+// Each N is run with three layouts of the groups:
+//
+//   earliest  The oldest file format, i.e. groups are symbol tables.
+//   compact   Links and attributes stored in the object header, up to 64
+//             of them; beyond, they move to dense storage. The time to move
+//             them grows quickly with the threshold, e.g. seconds for 256
+//             links, hence larger thresholds make large N impractical.
+//   dense     Links and attributes stored in B-trees and fractal heaps.
+//
+// The results are reported in operations per second. Operations that aren't
+// supported by a layout, e.g. many attributes in the earliest format, are
+// reported as "n/a".
+
+#include <highfive/H5DataSet.hpp>
+#include <highfive/H5File.hpp>
+#include <highfive/H5Group.hpp>
+#include <highfive/H5Reference.hpp>
+#include <highfive/H5Utility.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace HighFive;
+
+struct Layout {
+    std::string name;
+    H5F_libver_t low;
+    unsigned max_compact;
+    unsigned min_dense;
+};
+
+std::string object_name(size_t i) {
+    return "object_" + std::to_string(i);
+}
+
+// Applies `f` to 0, ..., n - 1 and returns the operations per second.
+template <typename F>
+double ops_per_second(size_t n, F f) {
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < n; ++i) {
+        f(i);
+    }
+    auto stop = std::chrono::steady_clock::now();
+    return double(n) / std::chrono::duration<double>(stop - start).count();
+}
+
+void report(const Layout& layout, size_t n, const std::string& operation, double rate) {
+    std::cout << std::setw(9) << layout.name << std::setw(9) << n << "  " << std::setw(22)
+              << std::left << operation << std::right << std::setw(14) << std::fixed
+              << std::setprecision(0) << rate << " ops/s" << std::endl;
+}
+
+template <typename F>
+void run(const Layout& layout, size_t n, const std::string& operation, F f) {
+    // Unsupported operations are expected, see "n/a".
+    SilenceHDF5 silence;
+    try {
+        report(layout, n, operation, ops_per_second(n, f));
+    } catch (const Exception&) {
+        std::cout << std::setw(9) << layout.name << std::setw(9) << n << "  " << std::setw(22)
+                  << std::left << operation << std::right << std::setw(14) << "n/a\n";
+    }
+}
+
+void bench(const Layout& layout, size_t n) {
+    FileAccessProps fapl;
+    fapl.add(FileVersionBounds(layout.low, H5F_LIBVER_LATEST));
+
+    GroupCreateProps gcpl;
+    if (layout.low != H5F_LIBVER_EARLIEST) {
+        gcpl.add(LinkPhaseChange(layout.max_compact, layout.min_dense));
+        gcpl.add(AttributePhaseChange(layout.max_compact, layout.min_dense));
+    }
+
+    const std::string filename = "metadata_bench_" + layout.name + ".h5";
+    {
+        File file(filename, File::Truncate, fapl);
+        auto groups = file.createGroup("groups", gcpl);
+        auto datasets = file.createGroup("datasets", gcpl);
+        auto attributes = file.createGroup("attributes", gcpl);
+
+        run(layout, n, "createGroup", [&](size_t i) { groups.createGroup(object_name(i)); });
+        run(layout, n, "createDataSet", [&](size_t i) {
+            datasets.createDataSet<int>(object_name(i), DataSpace(DataSpace::dataspace_scalar));
+        });
+        run(layout, n, "createAttribute", [&](size_t i) {
+            attributes.createAttribute(object_name(i), int(i));
+        });
+
+        // Only time creating the references, not opening the groups.
+        std::vector<Group> targets;
+        targets.reserve(n);
+        for (size_t i = 0; i < n; ++i) {
+            targets.push_back(groups.getGroup(object_name(i)));
+        }
+
+        std::vector<Reference> references;
+        references.reserve(n);
+        run(layout, n, "Reference", [&](size_t i) { references.emplace_back(file, targets[i]); });
+        file.createDataSet("references", references);
+    }
+
+    File file(filename, File::ReadOnly, fapl);
+    auto groups = file.getGroup("groups");
+    auto attributes = file.getGroup("attributes");
+
+    // Listing is a single call, report the names listed per second.
+    auto list = [&](size_t) { groups.listObjectNames(); };
+    report(layout, n, "listObjectNames", ops_per_second(1, list) * double(n));
+    run(layout, n, "exist", [&](size_t i) { groups.exist(object_name(i)); });
+    run(layout, n, "getObjectType", [&](size_t i) { groups.getObjectType(object_name(i)); });
+    run(layout, n, "getGroup", [&](size_t i) { groups.getGroup(object_name(i)); });
+    run(layout, n, "getAttribute().read", [&](size_t i) {
+        attributes.getAttribute(object_name(i)).read<int>();
+    });
+
+    auto references = file.getDataSet("references").read<std::vector<Reference>>();
+    run(layout, n, "Reference::dereference", [&](size_t i) {
+        references[i].dereference<Group>(file);
+    });
+}
+
+int main(int argc, char* argv[]) {
+    std::vector<size_t> sizes;
+    for (int i = 1; i < argc; ++i) {
+        sizes.push_back(std::strtoul(argv[i], nullptr, 10));
+    }
+    if (sizes.empty()) {
+        sizes = {1000, 10000};
+    }
+
+    const std::vector<Layout> layouts = {{"earliest", H5F_LIBVER_EARLIEST, 0, 0},
+                                         {"compact", H5F_LIBVER_V18, 64, 48},
+                                         {"dense", H5F_LIBVER_V18, 0, 0}};
+
+    for (auto n: sizes) {
+        for (const auto& layout: layouts) {
+            bench(layout, n);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,336 @@
+// IOR-style benchmark of parallel HDF5 through HighFive.
+//
+// Usage: mpirun -n N highfive_parallel_bench [--file PATH] [--block BYTES]
+//            [--transfer BYTES] [--segments N] [--groups N] [--ranks LIST]
+//            [--output PATH]
+//
+//   --file PATH       The file to benchmark, on the parallel file system.
+//                     Default: parallel_bench.h5.
+//   --block BYTES     The bytes per rank and segment. Default: 1 MiB.
+//   --transfer BYTES  The bytes per read or write, must divide the block.
+//                     Default: 64 KiB.
+//   --segments N      The number of segments. Default: 4.
+//   --groups N        The number of groups of the metadata benchmark.
+//                     Default: 256.
+//   --ranks LIST      A comma separated list of rank counts, e.g. 1,4,16.
+//                     Default: the powers of two up to N, and N.
+//   --output PATH     Write the results to PATH instead of stdout.
+//
+// The dataset is a one dimensional array of bytes made of `segments`
+// segments, each of size `ranks * block`. Every rank accesses `block` bytes
+// per segment, one transfer at a time:
+//
+//   segmented  Each rank accesses a contiguous block of every segment.
+//   strided    The transfers of the ranks are interleaved.
+//   random     The transfers of a segment are shuffled.
+//
+// Each pattern is written and read back, with collective and independent
+// I/O, and with a contiguous and a chunked layout, with one chunk per
+// transfer. The metadata benchmark creates groups with an attribute each,
+// then opens them and reads the attribute on all ranks, with and without
+// collective metadata I/O.
+//
+// The results are written as a JSON array with one object per measurement.
+// Bandwidths are in MiB/s; the time of a measurement is the time of the
+// slowest rank.
+
+#include <highfive/H5DataSet.hpp>
+#include <highfive/H5File.hpp>
+#include <highfive/H5Group.hpp>
+
+#include <mpi.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace HighFive;
+
+struct Options {
+    std::string file = "parallel_bench.h5";
+    size_t block = 1024 * 1024;
+    size_t transfer = 64 * 1024;
+    size_t segments = 4;
+    size_t groups = 256;
+    std::vector<int> ranks;
+    std::string output;
+};
+
+std::vector<int> parse_list(const std::string& list) {
+    std::vector<int> values;
+    std::stringstream stream(list);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        values.push_back(std::atoi(item.c_str()));
+    }
+    return values;
+}
+
+Options parse_options(int argc, char* argv[], int mpi_size) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            throw std::invalid_argument("Missing value of argument: " + arg);
+        }
+        const std::string value = argv[++i];
+        if (arg == "--file") {
+            options.file = value;
+        } else if (arg == "--block") {
+            options.block = std::strtoul(value.c_str(), nullptr, 10);
+        } else if (arg == "--transfer") {
+            options.transfer = std::strtoul(value.c_str(), nullptr, 10);
+        } else if (arg == "--segments") {
+            options.segments = std::strtoul(value.c_str(), nullptr, 10);
+        } else if (arg == "--groups") {
+            options.groups = std::strtoul(value.c_str(), nullptr, 10);
+        } else if (arg == "--ranks") {
+            options.ranks = parse_list(value);
+        } else if (arg == "--output") {
+            options.output = value;
+        } else {
+            throw std::invalid_argument("Unknown argument: " + arg);
+        }
+    }
+
+    if (options.transfer == 0 || options.block % options.transfer != 0) {
+        throw std::invalid_argument("The transfer size must divide the block size.");
+    }
+    if (options.ranks.empty()) {
+        for (int n = 1; n < mpi_size; n *= 2) {
+            options.ranks.push_back(n);
+        }
+        options.ranks.push_back(mpi_size);
+    }
+    for (int n: options.ranks) {
+        if (n < 1 || n > mpi_size) {
+            throw std::invalid_argument("Invalid rank count: " + std::to_string(n));
+        }
+    }
+    return options;
+}
+
+enum class Pattern { Segmented, Strided, Random };
+
+const char* to_string(Pattern pattern) {
+    switch (pattern) {
+    case Pattern::Segmented:
+        return "segmented";
+    case Pattern::Strided:
+        return "strided";
+    default:
+        return "random";
+    }
+}
+
+// The offsets of the transfers of `rank`, in the order in which they're accessed.
+std::vector<size_t> transfer_offsets(Pattern pattern,
+                                     const Options& options,
+                                     size_t rank,
+                                     size_t n_ranks) {
+    const size_t per_block = options.block / options.transfer;
+    const size_t segment_size = n_ranks * options.block;
+
+    // The same seed on all ranks, hence the same permutation.
+    std::mt19937 generator(42);
+    std::vector<size_t> slots(per_block * n_ranks);
+
+    std::vector<size_t> offsets;
+    offsets.reserve(options.segments * per_block);
+    for (size_t s = 0; s < options.segments; ++s) {
+        std::iota(slots.begin(), slots.end(), size_t(0));
+        if (pattern == Pattern::Random) {
+            std::shuffle(slots.begin(), slots.end(), generator);
+        }
+        for (size_t t = 0; t < per_block; ++t) {
+            size_t slot = 0;
+            if (pattern == Pattern::Strided) {
+                slot = t * n_ranks + rank;
+            } else {
+                slot = slots[rank * per_block + t];
+            }
+            offsets.push_back(s * segment_size + slot * options.transfer);
+        }
+    }
+    return offsets;
+}
+
+struct Json {
+    std::vector<std::string> records;
+
+    void add(const std::string& record) {
+        records.push_back("  {" + record + "}");
+    }
+
+    void write(std::ostream& out) const {
+        out << "[\n";
+        for (size_t i = 0; i < records.size(); ++i) {
+            out << records[i] << (i + 1 < records.size() ? ",\n" : "\n");
+        }
+        out << "]\n";
+    }
+};
+
+// The time of the slowest rank.
+double max_time(double seconds, MPI_Comm comm) {
+    double result = 0.0;
+    MPI_Allreduce(&seconds, &result, 1, MPI_DOUBLE, MPI_MAX, comm);
+    return result;
+}
+
+FileAccessProps parallel_fapl(MPI_Comm comm, bool collective_metadata) {
+    FileAccessProps fapl;
+    fapl.add(MPIOFileAccess(comm, MPI_INFO_NULL));
+    fapl.add(MPIOCollectiveMetadata(collective_metadata));
+    return fapl;
+}
+
+void bench_io(const Options& options, MPI_Comm comm, Json& json) {
+    int mpi_rank = 0, mpi_size = 0;
+    MPI_Comm_rank(comm, &mpi_rank);
+    MPI_Comm_size(comm, &mpi_size);
+    const auto rank = static_cast<size_t>(mpi_rank);
+    const auto n_ranks = static_cast<size_t>(mpi_size);
+
+    const size_t size = options.segments * n_ranks * options.block;
+    std::vector<uint8_t> buffer(options.transfer, static_cast<uint8_t>(rank));
+
+    for (auto pattern: {Pattern::Segmented, Pattern::Strided, Pattern::Random}) {
+        const auto offsets = transfer_offsets(pattern, options, rank, n_ranks);
+        for (bool chunked: {false, true}) {
+            for (bool collective: {true, false}) {
+                DataTransferProps xfer_props;
+                xfer_props.add(UseCollectiveIO(collective));
+
+                File file(options.file, File::Truncate, parallel_fapl(comm, false));
+                DataSetCreateProps dcpl;
+                if (chunked) {
+                    dcpl.add(Chunking(std::vector<hsize_t>{options.transfer}));
+                }
+                auto dataset = file.createDataSet<uint8_t>("data", DataSpace({size}), dcpl);
+
+                for (const char* operation: {"write", "read"}) {
+                    const bool write = operation[0] == 'w';
+                    MPI_Barrier(comm);
+                    const double start = MPI_Wtime();
+                    for (auto offset: offsets) {
+                        auto selection = dataset.select({offset}, {options.transfer});
+                        if (write) {
+                            selection.write_raw(buffer.data(), xfer_props);
+                        } else {
+                            selection.read(buffer.data(), xfer_props);
+                        }
+                    }
+                    if (write) {
+                        file.flush();
+                    }
+                    const double seconds = max_time(MPI_Wtime() - start, comm);
+
+                    std::stringstream record;
+                    record << "\"benchmark\": \"io\", \"pattern\": \"" << to_string(pattern)
+                           << "\", \"operation\": \"" << operation << "\", \"ranks\": " << n_ranks
+                           << ", \"collective\": " << (collective ? "true" : "false")
+                           << ", \"layout\": \"" << (chunked ? "chunked" : "contiguous")
+                           << "\", \"block\": " << options.block
+                           << ", \"transfer\": " << options.transfer
+                           << ", \"segments\": " << options.segments << ", \"bytes\": " << size
+                           << ", \"seconds\": " << seconds << ", \"bandwidth_mib_s\": "
+                           << double(size) / (1024.0 * 1024.0) / seconds;
+                    json.add(record.str());
+                }
+            }
+        }
+    }
+}
+
+void bench_metadata(const Options& options, MPI_Comm comm, Json& json) {
+    int mpi_size = 0;
+    MPI_Comm_size(comm, &mpi_size);
+
+    for (bool collective: {true, false}) {
+        File file(options.file, File::Truncate, parallel_fapl(comm, collective));
+
+        // Creating objects is always collective.
+        MPI_Barrier(comm);
+        double start = MPI_Wtime();
+        for (size_t i = 0; i < options.groups; ++i) {
+            auto group = file.createGroup("group_" + std::to_string(i));
+            group.createAttribute("index", static_cast<int>(i));
+        }
+        file.flush();
+        const double create = max_time(MPI_Wtime() - start, comm);
+
+        // Every rank opens every group and reads its attribute.
+        MPI_Barrier(comm);
+        start = MPI_Wtime();
+        int sum = 0;
+        for (size_t i = 0; i < options.groups; ++i) {
+            auto group = file.getGroup("group_" + std::to_string(i));
+            sum += group.getAttribute("index").read<int>();
+        }
+        const double open = max_time(MPI_Wtime() - start, comm);
+        if (sum != static_cast<int>(options.groups * (options.groups - 1) / 2)) {
+            throw std::runtime_error("Unexpected attribute values.");
+        }
+
+        const double seconds[2] = {create, open};
+        const char* operations[2] = {"create", "open"};
+        for (int k = 0; k < 2; ++k) {
+            std::stringstream record;
+            record << "\"benchmark\": \"metadata\", \"operation\": \"" << operations[k]
+                   << "\", \"ranks\": " << mpi_size
+                   << ", \"collective_metadata\": " << (collective ? "true" : "false")
+                   << ", \"ops\": " << options.groups << ", \"seconds\": " << seconds[k]
+                   << ", \"ops_per_s\": " << double(options.groups) / seconds[k];
+            json.add(record.str());
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+    MPI_Init(&argc, &argv);
+
+    int mpi_rank = 0, mpi_size = 0;
+    MPI_Comm_rank(MPI_COMM_WORLD, &mpi_rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &mpi_size);
+
+    try {
+        const auto options = parse_options(argc, argv, mpi_size);
+
+        Json json;
+        for (int n_ranks: options.ranks) {
+            // The first `n_ranks` ranks run the benchmarks, the others wait.
+            MPI_Comm comm;
+            MPI_Comm_split(MPI_COMM_WORLD, mpi_rank < n_ranks ? 0 : MPI_UNDEFINED, mpi_rank, &comm);
+            if (comm != MPI_COMM_NULL) {
+                bench_io(options, comm, json);
+                bench_metadata(options, comm, json);
+                MPI_Comm_free(&comm);
+            }
+            MPI_Barrier(MPI_COMM_WORLD);
+        }
+
+        if (mpi_rank == 0) {
+            if (options.output.empty()) {
+                json.write(std::cout);
+            } else {
+                std::ofstream out(options.output);
+                json.write(out);
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "rank " << mpi_rank << ": " << e.what() << std::endl;
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+
+    MPI_Finalize();
+    return 0;
+}
@@ -0,0 +1,181 @@
+// Replays a trace recorded with `HighFive::IOTrace` against a synthetic file.
+//
+// Usage: highfive_replay TRACE [--chunk ROWS] [--cache BYTES] [--core]
+//
+//   --chunk ROWS   Store every dataset chunked, with ROWS rows per chunk and
+//                  the full extent in all other dimensions. Default: contiguous.
+//   --cache BYTES  Size of the chunk cache of every dataset.
+//   --core         Use the in-memory driver instead of sec2.
+//
+// Every file of the trace is replayed in its own file, replay.0.h5,
+// replay.1.h5, ... Every dataset of the trace is created, at the same path,
+// as an array of bytes of the same size and shape, the element size being
+// folded into the last dimension.
+// Each access is replayed as a hyperslab covering the bounding box of the
+// original selection, as fast as possible. The time spent reading and writing
+// is reported next to the time recorded in the trace, with the number of
+// strided or point selections, which access more than they originally did.
+
+#include <highfive/H5DataSet.hpp>
+#include <highfive/H5File.hpp>
+#include <highfive/H5IOTrace.hpp>
+
+#include <H5FDcore.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace HighFive;
+
+struct Options {
+    std::string trace;
+    size_t chunk_rows = 0;
+    size_t cache_size = 0;
+    bool core = false;
+};
+
+Options parse_options(int argc, char* argv[]) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--chunk" && i + 1 < argc) {
+            options.chunk_rows = std::strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--cache" && i + 1 < argc) {
+            options.cache_size = std::strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--core") {
+            options.core = true;
+        } else if (options.trace.empty()) {
+            options.trace = arg;
+        } else {
+            throw std::invalid_argument("Unknown argument: " + arg);
+        }
+    }
+    if (options.trace.empty()) {
+        throw std::invalid_argument(
+            "Usage: highfive_replay TRACE [--chunk ROWS] [--cache BYTES] [--core]");
+    }
+    return options;
+}
+
+// The in-memory driver, without backing store.
+struct CoreDriver {
+    void apply(hid_t list) const {
+        H5Pset_fapl_core(list, 64 * 1024 * 1024, 0);
+    }
+};
+
+// The shape of the dataset as an array of bytes.
+std::vector<size_t> byte_dims(const std::vector<size_t>& dims, size_t element_size) {
+    if (dims.empty()) {
+        return {element_size};
+    }
+    auto result = dims;
+    result.back() *= element_size;
+    return result;
+}
+
+DataSet create_dataset(File& file, const IOTrace::Event& event, const Options& options) {
+    const auto dims = byte_dims(event.dataset_dims, event.element_size);
+
+    DataSetCreateProps dcpl;
+    if (options.chunk_rows > 0) {
+        std::vector<hsize_t> chunk(dims.begin(), dims.end());
+        chunk[0] = std::max<hsize_t>(1, std::min<hsize_t>(options.chunk_rows, chunk[0]));
+        dcpl.add(Chunking(chunk));
+    }
+
+    DataSetAccessProps dapl;
+    if (options.cache_size > 0) {
+        dapl.add(Caching(521, options.cache_size));
+    }
+
+    const auto name = event.dataset.empty() ? std::string("anonymous") : event.dataset;
+    return file.createDataSet<uint8_t>(name, DataSpace(dims), dcpl, dapl);
+}
+
+int main(int argc, char* argv[]) {
+    const auto options = parse_options(argc, argv);
+    const auto events = IOTrace::load(options.trace);
+
+    FileAccessProps fapl;
+    if (options.core) {
+        fapl.add(CoreDriver());
+    }
+    // By name of the traced file, and by name of the traced file and path.
+    std::map<std::string, std::unique_ptr<File>> files;
+    std::map<std::pair<std::string, std::string>, DataSet> datasets;
+    std::vector<uint8_t> buffer;
+
+    double traced[2] = {0.0, 0.0};
+    double replayed[2] = {0.0, 0.0};
+    size_t n_bytes[2] = {0, 0};
+    size_t n_widened = 0;
+
+    for (const auto& event: events) {
+        auto& file = files[event.file];
+        if (!file) {
+            const auto name = "replay." + std::to_string(files.size() - 1) + ".h5";
+            file.reset(new File(name, File::Truncate, fapl));
+        }
+
+        const auto key = std::make_pair(event.file, event.dataset);
+        auto it = datasets.find(key);
+        if (it == datasets.end()) {
+            it = datasets.emplace(key, create_dataset(*file, event, options)).first;
+        }
+
+        auto offset = event.offset;
+        auto count = event.count;
+        if (offset.empty()) {
+            offset = {0};
+            count = {1};
+        }
+        offset.back() *= event.element_size;
+        count.back() *= event.element_size;
+
+        size_t size = 1;
+        for (auto c: count) {
+            size *= c;
+        }
+        if (size == 0) {
+            continue;
+        }
+        buffer.resize(size);
+
+        if (event.selection == IOTrace::SelectionType::Hyperslab ||
+            event.selection == IOTrace::SelectionType::Points) {
+            ++n_widened;
+        }
+
+        const int op = event.operation == IOTrace::Operation::Read ? 0 : 1;
+        auto start = std::chrono::steady_clock::now();
+        auto selection = it->second.select(offset, count);
+        if (op == 0) {
+            selection.read(buffer.data());
+        } else {
+            selection.write_raw(buffer.data());
+        }
+        auto stop = std::chrono::steady_clock::now();
+
+        replayed[op] += std::chrono::duration<double>(stop - start).count();
+        traced[op] += double(event.duration) * 1e-9;
+        n_bytes[op] += size;
+    }
+
+    const char* names[2] = {"read ", "write"};
+    for (int op = 0; op < 2; ++op) {
+        std::cout << names[op] << ": " << n_bytes[op] << " bytes, traced " << traced[op]
+                  << " s, replayed " << replayed[op] << " s\n";
+    }
+    if (n_widened > 0) {
+        std::cout << n_widened << " strided or point selections replayed as their bounding box\n";
+    }
+    return 0;
+}
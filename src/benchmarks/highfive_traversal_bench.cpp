@@ -0,0 +1,76 @@
+// Compares the latency of traversing a deep hierarchy stored in a single file
+// against the same hierarchy stored with the split driver, i.e. with the
+// metadata in its own, small file.
+//
+// Usage: highfive_traversal_bench [META_EXT [RAW_EXT]]
+//
+// The extensions are passed to `SplitDriver`; use a `%s` format pointing to
+// another file system to place the metadata on faster storage. For meaningful
+// numbers on cold storage, drop the page cache between writing and traversing.
+
+#include <highfive/H5File.hpp>
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+const int DEPTH = 4;
+const int FANOUT = 8;
+const size_t DATASET_SIZE = 4096;
+
+void create_tree(HighFive::Group group, int depth, const std::vector<double>& values) {
+    group.createAttribute("depth", depth);
+    group.createDataSet("values", values);
+    if (depth == DEPTH) {
+        return;
+    }
+    for (int i = 0; i < FANOUT; ++i) {
+        create_tree(group.createGroup("g" + std::to_string(i)), depth + 1, values);
+    }
+}
+
+size_t traverse(const HighFive::Group& group) {
+    size_t n_visited = 1;
+    group.getAttribute("depth").read<int>();
+    for (const auto& name: group.listObjectNames()) {
+        if (group.getObjectType(name) == HighFive::ObjectType::Group) {
+            n_visited += traverse(group.getGroup(name));
+        } else {
+            group.getDataSet(name).getDimensions();
+            n_visited += 1;
+        }
+    }
+    return n_visited;
+}
+
+double time_traversal(const std::string& filename, const HighFive::FileAccessProps& fapl) {
+    auto start = std::chrono::steady_clock::now();
+    HighFive::File file(filename, HighFive::File::ReadOnly, fapl);
+    traverse(file.getGroup("/"));
+    auto stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(stop - start).count();
+}
+
+int main(int argc, char* argv[]) {
+    const std::string meta_ext = argc > 1 ? argv[1] : "-m.h5";
+    const std::string raw_ext = argc > 2 ? argv[2] : "-r.h5";
+
+    const std::vector<double> values(DATASET_SIZE, 1.0);
+
+    auto single = HighFive::FileAccessProps::Default();
+    HighFive::FileAccessProps split;
+    split.add(HighFive::SplitDriver(meta_ext, raw_ext));
+
+    create_tree(HighFive::File("traversal_single.h5", HighFive::File::Truncate, single)
+                    .getGroup("/"),
+                0,
+                values);
+    create_tree(HighFive::File("traversal_split", HighFive::File::Truncate, split).getGroup("/"),
+                0,
+                values);
+
+    std::cout << "single file: " << time_traversal("traversal_single.h5", single) << " s\n";
+    std::cout << "split:       " << time_traversal("traversal_split", split) << " s\n";
+    return 0;
+}
@@ -0,0 +1,171 @@
+// Hardware performance counters and resource usage around a benchmark case.
+//
+// On Linux, the counters are read with `perf_event_open`; they're unavailable
+// if the kernel doesn't allow it, e.g. because of
+// `/proc/sys/kernel/perf_event_paranoid` or in containers. System calls are
+// counted with the `raw_syscalls:sys_enter` tracepoint, which also requires
+// tracefs to be mounted and readable. The resource usage is read with
+// `getrusage` and is always available.
+#pragma once
+
+#include <sys/resource.h>
+
+#include <cstdint>
+#include <fstream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+struct PerfSample {
+    // Negative if the counter is unavailable.
+    int64_t cycles = -1;
+    int64_t instructions = -1;
+    // Loads which missed the last level cache.
+    int64_t llc_misses = -1;
+    int64_t page_faults = -1;
+    int64_t syscalls = -1;
+
+    // From `getrusage`.
+    long minor_faults = 0;
+    long major_faults = 0;
+    long block_inputs = 0;
+    long block_outputs = 0;
+    long context_switches = 0;
+};
+
+class PerfCounters {
+  public:
+    PerfCounters() {
+#ifdef __linux__
+        _fds.push_back(open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES));
+        _fds.push_back(open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS));
+        _fds.push_back(open(PERF_TYPE_HW_CACHE,
+                            PERF_COUNT_HW_CACHE_LL | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)));
+        _fds.push_back(open(PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS));
+
+        // The tracepoint fires in the kernel, it can't exclude the kernel.
+        const int64_t sys_enter = tracepoint_id("raw_syscalls/sys_enter");
+        _fds.push_back(sys_enter < 0
+                           ? -1
+                           : open(PERF_TYPE_TRACEPOINT, static_cast<uint64_t>(sys_enter), false));
+#endif
+    }
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    ~PerfCounters() {
+#ifdef __linux__
+        for (int fd: _fds) {
+            if (fd >= 0) {
+                close(fd);
+            }
+        }
+#endif
+    }
+
+    void start() {
+#ifdef __linux__
+        for (int fd: _fds) {
+            if (fd >= 0) {
+                ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+                ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+            }
+        }
+#endif
+        getrusage(RUSAGE_SELF, &_usage);
+    }
+
+    PerfSample stop() {
+        PerfSample sample;
+#ifdef __linux__
+        int64_t* counters[] = {&sample.cycles,
+                               &sample.instructions,
+                               &sample.llc_misses,
+                               &sample.page_faults,
+                               &sample.syscalls};
+        for (size_t i = 0; i < _fds.size(); ++i) {
+            uint64_t value = 0;
+            if (_fds[i] >= 0) {
+                ioctl(_fds[i], PERF_EVENT_IOC_DISABLE, 0);
+                if (read(_fds[i], &value, sizeof(value)) == sizeof(value)) {
+                    *counters[i] = static_cast<int64_t>(value);
+                }
+            }
+        }
+#endif
+        struct rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+        sample.minor_faults = usage.ru_minflt - _usage.ru_minflt;
+        sample.major_faults = usage.ru_majflt - _usage.ru_majflt;
+        sample.block_inputs = usage.ru_inblock - _usage.ru_inblock;
+        sample.block_outputs = usage.ru_oublock - _usage.ru_oublock;
+        sample.context_switches = (usage.ru_nvcsw - _usage.ru_nvcsw) +
+                                  (usage.ru_nivcsw - _usage.ru_nivcsw);
+        return sample;
+    }
+
+  private:
+#ifdef __linux__
+    static int open(uint32_t type, uint64_t config, bool exclude_kernel = true) {
+        struct perf_event_attr attr = {};
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.disabled = 1;
+        attr.exclude_kernel = exclude_kernel ? 1 : 0;
+        attr.exclude_hv = 1;
+        return static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+
+    // The id of the tracepoint `event`, e.g. "raw_syscalls/sys_enter", or -1.
+    static int64_t tracepoint_id(const char* event) {
+        const char* roots[] = {"/sys/kernel/tracing", "/sys/kernel/debug/tracing"};
+        for (const char* root: roots) {
+            std::ifstream file(std::string(root) + "/events/" + event + "/id");
+            int64_t id = -1;
+            if (file >> id) {
+                return id;
+            }
+        }
+        return -1;
+    }
+#endif
+
+    std::vector<int> _fds;
+    struct rusage _usage = {};
+};
+
+// Prints the sample, normalized by the number of bytes processed.
+inline void print_sample(std::ostream& out, const PerfSample& sample, size_t n_bytes) {
+    const double mib = double(n_bytes) / (1024.0 * 1024.0);
+    if (sample.cycles > 0) {
+        out << "  bytes/cycle " << double(n_bytes) / double(sample.cycles);
+    }
+    if (sample.cycles > 0 && sample.instructions >= 0) {
+        out << "  IPC " << double(sample.instructions) / double(sample.cycles);
+    }
+    if (sample.llc_misses >= 0) {
+        out << "  LLC misses/MiB " << double(sample.llc_misses) / mib;
+    }
+    if (sample.page_faults >= 0) {
+        out << "  page faults " << sample.page_faults;
+    }
+    if (sample.syscalls >= 0) {
+        out << "  syscalls " << sample.syscalls;
+    }
+    if (sample.cycles < 0) {
+        out << "  (perf counters unavailable)";
+    }
+    out << "  minor/major faults " << sample.minor_faults << "/" << sample.major_faults
+        << "  block in/out " << sample.block_inputs << "/" << sample.block_outputs
+        << "  context switches " << sample.context_switches;
+}
@@ -12,6 +12,10 @@ for exe in $executables; do
     time ./$exe
 done
 
+# Hardware counters and resource usage of the converter paths
+echo -e "\nRunning highfive_converter_bench"
+./highfive_converter_bench
+
 if [ $# -eq 0 ]; then
     echo "Not running hpctoolkit. Please provide a CLI argument to proceed"
     exit 0
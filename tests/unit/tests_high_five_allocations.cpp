@@ -0,0 +1,163 @@
+/*
+ *  Copyright (c), 2023, Blue Brain Project - EPFL
+ *
+ *  Distributed under the Boost Software License, Version 1.0.
+ *    (See accompanying file LICENSE_1_0.txt or copy at
+ *          http://www.boost.org/LICENSE_1_0.txt)
+ *
+ */
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+
+#include <highfive/H5DataSet.hpp>
+#include <highfive/H5DataSpace.hpp>
+#include <highfive/H5File.hpp>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+using namespace HighFive;
+
+// All allocations through `operator new` are counted, i.e. those of HighFive
+// and the standard library, but not those of HDF5 itself.
+namespace {
+std::atomic<size_t> n_allocations{0};
+std::atomic<size_t> n_allocated_bytes{0};
+
+void* counted_malloc(std::size_t size) {
+    n_allocations++;
+    n_allocated_bytes += size;
+    if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+struct Allocations {
+    size_t count;
+    size_t bytes;
+};
+
+// The allocations made by calling `f`.
+template <class F>
+Allocations count_allocations(F f) {
+    const size_t count = n_allocations;
+    const size_t bytes = n_allocated_bytes;
+    f();
+    return {n_allocations - count, n_allocated_bytes - bytes};
+}
+}  // namespace
+
+void* operator new(std::size_t size) {
+    return counted_malloc(size);
+}
+
+void* operator new[](std::size_t size) {
+    return counted_malloc(size);
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+// The budgets are the allocations needed at the time of writing. Raising one
+// of them requires a good reason; lower them when an allocation is removed.
+
+TEST_CASE("Allocations of reading a scalar") {
+    File file("h5_allocations_scalar.h5", File::Truncate);
+    auto dataset = file.createDataSet("x", 42);
+
+    int value = 0;
+    auto allocations = count_allocations([&]() { dataset.read(value); });
+    CHECK(allocations.count <= 2);
+    CHECK(allocations.bytes <= 64);
+    CHECK(value == 42);
+}
+
+TEST_CASE("Allocations of reading a vector") {
+    const size_t n = 1000;
+    File file("h5_allocations_vector.h5", File::Truncate);
+    auto dataset = file.createDataSet("x", std::vector<double>(n, 1.0));
+
+    // The vector already has the right size.
+    std::vector<double> values(n);
+    auto allocations = count_allocations([&]() { dataset.read(values); });
+    CHECK(allocations.count <= 6);
+    CHECK(allocations.bytes <= 128);
+
+    // The vector needs to be resized, once.
+    std::vector<double> empty;
+    allocations = count_allocations([&]() { dataset.read(empty); });
+    CHECK(allocations.count <= 7);
+    CHECK(allocations.bytes <= n * sizeof(double) + 128);
+    CHECK(empty == values);
+}
+
+TEST_CASE("Allocations of reading a nested vector") {
+    const size_t n_rows = 100, n_cols = 10;
+    File file("h5_allocations_nested_vector.h5", File::Truncate);
+    auto written = std::vector<std::vector<double>>(n_rows, std::vector<double>(n_cols, 1.0));
+    auto dataset = file.createDataSet("x", written);
+
+    // One buffer for reading, the outer vector and one vector per row.
+    std::vector<std::vector<double>> values;
+    auto allocations = count_allocations([&]() { dataset.read(values); });
+    CHECK(allocations.count <= n_rows + 10);
+    CHECK(allocations.bytes <= 2 * n_rows * n_cols * sizeof(double) +
+                                   n_rows * sizeof(std::vector<double>) + 128);
+    CHECK(values == written);
+}
+
+TEST_CASE("Allocations of writing a selection") {
+    const size_t n = 1000, offset = 100, count = 500;
+    File file("h5_allocations_selection.h5", File::Truncate);
+    auto dataset = file.createDataSet<double>("x", DataSpace({n}));
+
+    std::vector<double> values(count, 2.0);
+    auto allocations = count_allocations(
+        [&]() { dataset.select({offset}, {count}).write(values); });
+    CHECK(allocations.count <= 12);
+    CHECK(allocations.bytes <= 512);
+}
+
+TEST_CASE("Per-call overhead compared to H5Dread", "[.][benchmark]") {
+    const size_t n = 16;
+    File file("h5_allocations_benchmark.h5", File::Truncate);
+    auto dataset = file.createDataSet("x", std::vector<double>(n, 1.0));
+    std::vector<double> values(n);
+
+    BENCHMARK("HighFive read") {
+        dataset.read(values);
+        return values[0];
+    };
+
+    BENCHMARK("HighFive read_raw") {
+        dataset.read(values.data());
+        return values[0];
+    };
+
+    BENCHMARK("H5Dread") {
+        H5Dread(dataset.getId(),
+                H5T_NATIVE_DOUBLE,
+                H5S_ALL,
+                H5S_ALL,
+                H5P_DEFAULT,
+                values.data());
+        return values[0];
+    };
+}
@@ -7,22 +7,40 @@
  *
  */
 #include <algorithm>
+#include <chrono>
 #include <cstdio>
 #include <cstdlib>
 #include <ctime>
+#include <fstream>
 #include <iostream>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <numeric>
 #include <random>
 #include <string>
+#include <thread>
 #include <typeinfo>
 #include <vector>
 
+#if defined(__unix__)
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#include <highfive/H5AsyncLogSink.hpp>
+#include <highfive/H5Checkpoint.hpp>
 #include <highfive/H5DataSet.hpp>
 #include <highfive/H5DataSpace.hpp>
 #include <highfive/H5File.hpp>
 #include <highfive/H5Group.hpp>
+#include <highfive/H5IOTrace.hpp>
+#include <highfive/H5IoUringDriver.hpp>
+#include <highfive/H5Memory.hpp>
+#include <highfive/H5MultiIO.hpp>
 #include <highfive/H5Reference.hpp>
+#include <highfive/H5SharedBlockCache.hpp>
+#include <highfive/H5Timeline.hpp>
 #include <highfive/H5Utility.hpp>
 #include <highfive/H5Version.hpp>
 
@@ -261,6 +279,133 @@ TEST_CASE("Test page buffer size") {
 #endif
 #endif
 
+#if defined(__unix__)
+TEST_CASE("SharedBlockCache") {
+    const std::string file_name("h5_shared_block_cache.h5");
+    const std::string cache_name("/highfive_test_cache_" + std::to_string(getpid()));
+    SharedBlockCache::remove(cache_name);
+
+    std::vector<double> values(20000);
+    std::iota(values.begin(), values.end(), 0.0);
+    {
+        File file(file_name, File::Truncate);
+        file.createDataSet("values", values);
+    }
+
+    // Room for 16 blocks of 4 kB, less than the 160 kB of data.
+    auto cache = SharedBlockCache(cache_name, 16 * 4096, 4096);
+    FileAccessProps fapl;
+    fapl.add(cache);
+    CHECK(SharedBlockCache(fapl).getName() == cache_name);
+    CHECK(SharedBlockCache(fapl).getBlockSize() == 4096);
+
+    auto read_values = [&]() {
+        return File(file_name, File::ReadOnly, fapl)
+            .getDataSet("values")
+            .read<std::vector<double>>();
+    };
+
+    CHECK(read_values() == values);
+    auto stats = cache.getStats();
+    CHECK(stats.misses > 0);
+    CHECK(stats.n_blocks == 16);
+    CHECK(stats.max_blocks == 16);
+    CHECK(stats.evictions > 0);
+
+    // Once read, the superblock and object headers are cached.
+    auto read_metadata = [&]() {
+        File(file_name, File::ReadOnly, fapl).getDataSet("values").getDimensions();
+    };
+    read_metadata();
+    cache.resetStats();
+    read_metadata();
+    stats = cache.getStats();
+    CHECK(stats.hits > 0);
+    CHECK(stats.misses == 0);
+    CHECK(stats.getHitRate() == 1.0);
+
+    // Another process finds the blocks this one read.
+    cache.resetStats();
+    const pid_t pid = fork();
+    REQUIRE(pid >= 0);
+    if (pid == 0) {
+        read_metadata();
+        _exit(0);
+    }
+    int status = -1;
+    waitpid(pid, &status, 0);
+    CHECK(status == 0);
+    CHECK(cache.getStats().hits > 0);
+    CHECK(cache.getStats().misses == 0);
+
+    {
+        SilenceHDF5 silencer;
+        CHECK_THROWS_AS(File(file_name, File::ReadWrite, fapl), FileException);
+    }
+    CHECK_THROWS_AS(SharedBlockCache("no_slash"), PropertyException);
+    CHECK_THROWS_AS(SharedBlockCache(cache_name, 100, 4096), PropertyException);
+
+    SharedBlockCache::remove(cache_name);
+}
+#endif
+
+#if defined(__linux__)
+TEST_CASE("IoUringDriver") {
+    const std::string file_name("h5_io_uring_driver.h5");
+
+    // Blocks of 4 kB split the 800 kB of the datasets into many requests.
+    FileAccessProps fapl;
+    fapl.add(IoUringDriver(8, 4096));
+    CHECK(IoUringDriver(fapl).getQueueDepth() == 8);
+    CHECK(IoUringDriver(fapl).getBlockSize() == 4096);
+    {
+        SilenceHDF5 silencer;
+        CHECK_THROWS_AS(IoUringDriver(FileAccessProps::Default()), PropertyException);
+    }
+    CHECK_THROWS_AS(IoUringDriver(0), PropertyException);
+    CHECK_THROWS_AS(IoUringDriver(8, 0), PropertyException);
+
+    const size_t nx = 100, ny = 1000;
+    std::vector<double> values(nx * ny);
+    std::iota(values.begin(), values.end(), 0.0);
+    {
+        File file(file_name, File::Truncate, fapl);
+        file.createDataSet<double>("contiguous", DataSpace({nx, ny})).write_raw(values.data());
+        DataSetCreateProps props;
+        props.add(Chunking(std::vector<hsize_t>{10, 1000}));
+        file.createDataSet<double>("chunked", DataSpace({nx, ny}), props)
+            .write_raw(values.data());
+    }
+
+    {
+        File file(file_name, File::ReadWrite, fapl);
+        for (const auto& name: {"contiguous", "chunked"}) {
+            auto dataset = file.getDataSet(name);
+            std::vector<double> result(nx * ny);
+            dataset.read(result.data());
+            CHECK(result == values);
+
+            std::vector<double> rows(2 * ny);
+            dataset.select({50, 0}, {2, ny}).read(rows.data());
+            CHECK(std::equal(rows.begin(), rows.end(), values.begin() + 50 * ny));
+        }
+
+        std::vector<double> row(ny, -1.0);
+        file.getDataSet("contiguous").select({nx - 1, 0}, {1, ny}).write_raw(row.data());
+    }
+
+    // Files written by the driver are plain HDF5 files.
+    std::vector<double> result(nx * ny);
+    File(file_name, File::ReadOnly).getDataSet("contiguous").read(result.data());
+    CHECK(std::equal(result.begin(), result.begin() + (nx - 1) * ny, values.begin()));
+    CHECK(result.back() == -1.0);
+
+    // The driver exposes a file descriptor.
+    auto contiguous = File(file_name, File::ReadOnly, fapl).getDataSet("contiguous");
+    CHECK(contiguous.adviseWillNeed({10, 0}, {2, ny}) == 2 * ny * sizeof(double));
+}
+#endif
+
 TEST_CASE("Test metadata block size assignment") {
     const std::string file_name("h5_meta_block_size.h5");
 
@@ -282,6 +427,148 @@ TEST_CASE("Test metadata block size assignment") {
     }
 }
 
+TEST_CASE("Test split and multi drivers") {
+    auto file_exists = [](const std::string& name) { return std::ifstream(name).good(); };
+
+    std::vector<double> values(1000);
+    std::iota(values.begin(), values.end(), 0.0);
+
+    SECTION("split") {
+        const std::string file_name("h5_split_driver");
+        FileAccessProps fapl;
+        fapl.add(SplitDriver("-meta.h5", "-raw.h5"));
+
+        {
+            File file(file_name, File::Truncate, fapl);
+            file.createGroup("a/b/c").createAttribute("x", 42);
+            file.createDataSet("a/values", values);
+        }
+
+        CHECK(file_exists(file_name + "-meta.h5"));
+        CHECK(file_exists(file_name + "-raw.h5"));
+        CHECK(!file_exists(file_name));
+
+        File file(file_name, File::ReadOnly, fapl);
+        CHECK(file.getGroup("a/b/c").getAttribute("x").read<int>() == 42);
+        CHECK(file.getDataSet("a/values").read<std::vector<double>>() == values);
+    }
+
+    SECTION("multi") {
+        const std::string file_name("h5_multi_driver");
+        FileAccessProps fapl;
+        fapl.add(MultiDriver({{H5FD_MEM_DRAW, "%s-raw.h5"}, {H5FD_MEM_OHDR, "%s-ohdr.h5"}}));
+
+        {
+            File file(file_name, File::Truncate, fapl);
+            file.createDataSet("values", values);
+        }
+
+        CHECK(file_exists(file_name + "-s.h5"));
+        CHECK(file_exists(file_name + "-raw.h5"));
+        CHECK(file_exists(file_name + "-ohdr.h5"));
+
+        File file(file_name, File::ReadOnly, fapl);
+        CHECK(file.getDataSet("values").read<std::vector<double>>() == values);
+    }
+}
+
+TEST_CASE("Test family driver") {
+    auto file_exists = [](const std::string& name) { return std::ifstream(name).good(); };
+    const std::string file_name("h5_family_%02d.h5");
+
+    std::vector<double> values(10000);
+    std::iota(values.begin(), values.end(), 0.0);
+
+    FileAccessProps fapl;
+    fapl.add(FamilyDriver(16 * 1024));
+    CHECK(FamilyDriver(fapl).getMemberSize() == 16 * 1024);
+
+    {
+        File file(file_name, File::Truncate, fapl);
+        file.createDataSet("values", values);
+    }
+
+    // 80 kB of data need at least 5 members.
+    for (int i = 0; i < 5; ++i) {
+        char member[32];
+        std::snprintf(member, sizeof(member), "h5_family_%02d.h5", i);
+        CHECK(file_exists(member));
+    }
+
+    File file(file_name, File::ReadOnly, fapl);
+    CHECK(file.getDataSet("values").read<std::vector<double>>() == values);
+
+    CHECK_THROWS_AS(File("h5_family.h5", File::Truncate, fapl), FileException);
+    CHECK_THROWS_AS(File("h5_family_%%d.h5", File::Truncate, fapl), FileException);
+    CHECK_THROWS_AS(File("h5_family_100%.h5", File::Truncate, fapl), FileException);
+    for (const auto& pattern: {"h5_family_%%_%u.h5", "h5_family_i%i.h5", "h5_family_w%+03d.h5"}) {
+        File(pattern, File::Truncate, fapl).createDataSet("values", values);
+        CHECK(File(pattern, File::ReadOnly, fapl).getDataSet("values").getElementCount() ==
+              values.size());
+    }
+
+    // The properties of the members are kept.
+    FileAccessProps member_fapl;
+    member_fapl.add(MetadataBlockSize(12345));
+    FileAccessProps family_fapl;
+    family_fapl.add(FamilyDriver(16 * 1024, member_fapl));
+
+    FileAccessProps copy_fapl;
+    copy_fapl.add(FamilyDriver(family_fapl));
+    hsize_t member_size = 0;
+    hid_t copied_member_fapl = H5I_INVALID_HID;
+    REQUIRE(H5Pget_fapl_family(copy_fapl.getId(), &member_size, &copied_member_fapl) >= 0);
+    hsize_t block_size = 0;
+    H5Pget_meta_block_size(copied_member_fapl, &block_size);
+    H5Pclose(copied_member_fapl);
+    CHECK(member_size == 16 * 1024);
+    CHECK(block_size == 12345);
+}
+
+#ifdef H5_HAVE_DIRECT
+TEST_CASE("Test direct I/O") {
+    const std::string file_name("h5_direct_io.h5");
+
+    FileAccessProps fapl;
+    fapl.add(DirectIO(4096, 4096, 1024 * 1024));
+
+    std::vector<double, AlignedAllocator<double>> values(1024);
+    std::iota(values.begin(), values.end(), 0.0);
+
+    {
+        File file(file_name, File::Truncate, fapl);
+        auto direct = DirectIO(file.getAccessPropertyList());
+        CHECK(direct.getAlignment() == 4096);
+        CHECK(direct.getCopyBufferSize() == 1024 * 1024);
+        auto dataset = file.createDataSet("values", values);
+        dataset.write(values);
+
+        // Checking the alignment of the buffers doesn't hold a handle of the file.
+        CHECK(H5Iget_ref(file.getId()) == 1);
+    }
+
+    File file(file_name, File::ReadOnly, fapl);
+    CHECK(file.getDataSet("values").read<std::vector<double>>() ==
+          std::vector<double>(values.begin(), values.end()));
+}
+#endif
+
+TEST_CASE("AlignedAllocator") {
+    const std::string file_name("h5_aligned_allocator.h5");
+
+    std::vector<int, AlignedAllocator<int, 512>> values(1000);
+    CHECK(reinterpret_cast<std::uintptr_t>(values.data()) % 512 == 0);
+    std::iota(values.begin(), values.end(), 0);
+
+    File file(file_name, File::Truncate);
+    auto dataset = file.createDataSet("values", values);
+
+    std::vector<int, AlignedAllocator<int, 512>> result;
+    dataset.read(result);
+    CHECK(reinterpret_cast<std::uintptr_t>(result.data()) % 512 == 0);
+    CHECK(result == values);
+}
+
 TEST_CASE("Test group properties") {
     const std::string file_name("h5_group_properties.h5");
     FileAccessProps fapl;
@@ -487,6 +774,57 @@ TEST_CASE("FreeSpace (tracked)") {
 }
 #endif
 
+TEST_CASE("Create file from template") {
+    const std::string template_name("template_skeleton.h5");
+
+    std::vector<char> image;
+    {
+        File file(template_name, File::Truncate);
+        DataSetCreateProps dcpl;
+        dcpl.add(Chunking(std::vector<hsize_t>{10}));
+        for (int i = 0; i < 10; ++i) {
+            auto group = file.createGroup("group_" + std::to_string(i));
+            group.createAttribute("index", i);
+            group.createDataSet<double>("data", DataSpace({100}), dcpl);
+        }
+        image = file.getFileImage();
+    }
+    CHECK(!image.empty());
+
+    auto check_skeleton = [](File& file) {
+        CHECK(file.getNumberObjects() == 10);
+        auto group = file.getGroup("group_7");
+        CHECK(group.getAttribute("index").read<int>() == 7);
+
+        auto data = std::vector<double>(100, 42.0);
+        auto dset = group.getDataSet("data");
+        CHECK(dset.getStorageSize() == 0);
+        dset.write(data);
+        CHECK(dset.read<std::vector<double>>() == data);
+    };
+
+    {
+        auto file = File::createFromTemplate(template_name, "from_template_path.h5");
+        check_skeleton(file);
+    }
+
+    {
+        auto file = File::createFromTemplate(image, "from_template_image.h5");
+        check_skeleton(file);
+    }
+
+    // The template can't be overwritten by itself.
+    CHECK_THROWS_AS(File::createFromTemplate(template_name, template_name), FileException);
+    CHECK_THROWS_AS(File::createFromTemplate(template_name, "./" + template_name),
+                    FileException);
+
+    // The template itself remains untouched.
+    File file(template_name, File::ReadOnly);
+    CHECK(file.getGroup("group_7").getDataSet("data").getStorageSize() == 0);
+
+    CHECK_THROWS_AS(File::createFromTemplate("no_such_template.h5", "other.h5"), FileException);
+}
+
 TEST_CASE("Test extensible datasets") {
     const std::string file_name("create_extensible_dataset_example.h5");
     const std::string dataset_name("dset");
@@ -1089,6 +1427,21 @@ TEST_CASE("AttributePhaseChange") {
     CHECK(actual.max_compact() == 42);
 }
 
+TEST_CASE("LinkPhaseChange") {
+    auto fapl = HighFive::FileAccessProps::Default();
+    fapl.add(HighFive::FileVersionBounds(H5F_LIBVER_LATEST, H5F_LIBVER_LATEST));
+    HighFive::File file("link_phase_change.h5", HighFive::File::Truncate, fapl);
+
+    auto gcpl = HighFive::GroupCreateProps::Default();
+    gcpl.add(HighFive::LinkPhaseChange(42, 24));
+
+    auto group = file.createGroup("grp", gcpl);
+
+    auto actual = LinkPhaseChange(group.getCreatePropertyList());
+    CHECK(actual.min_dense() == 24);
+    CHECK(actual.max_compact() == 42);
+}
+
 TEST_CASE("datasetOffset") {
     std::string filename = "datasetOffset.h5";
     std::string dsetname = "dset";
@@ -1102,6 +1455,653 @@ TEST_CASE("datasetOffset") {
     CHECK(ds_read.getOffset() > 0);
 }
 
+TEST_CASE("datasetAdviseWillNeed") {
+    const std::string filename = "datasetAdviseWillNeed.h5";
+    const size_t nx = 40, ny = 30;
+
+    std::vector<double> values(nx * ny);
+    std::iota(values.begin(), values.end(), 0.0);
+
+    {
+        File file(filename, File::Truncate);
+        DataSetCreateProps props;
+        props.add(Chunking(std::vector<hsize_t>{10, 10}));
+        file.createDataSet<double>("chunked", DataSpace({nx, ny}), props).write_raw(values.data());
+        file.createDataSet<double>("contiguous", DataSpace({nx, ny})).write_raw(values.data());
+        file.createDataSet<double>("wide", DataSpace({4, 1024}))
+            .write_raw(std::vector<double>(4 * 1024).data());
+
+        // Only the chunks of the first 10 rows are allocated.
+        file.createDataSet<double>("sparse", DataSpace({nx, ny}), props)
+            .select({0, 0}, {10, ny})
+            .write_raw(values.data());
+    }
+
+    File file(filename, File::ReadOnly);
+    auto chunked = file.getDataSet("chunked");
+    auto contiguous = file.getDataSet("contiguous");
+    auto wide = file.getDataSet("wide");
+    auto sparse = file.getDataSet("sparse");
+
+    CHECK(contiguous.adviseWillNeed() == nx * ny * sizeof(double));
+    CHECK(contiguous.adviseWillNeed({1, 0}, {2, ny}) == 2 * ny * sizeof(double));
+    // Rows of 240 bytes are merged, rows of 8 kB are hinted one by one.
+    CHECK(contiguous.adviseWillNeed({1, 5}, {3, 2}) == (2 * ny + 2) * sizeof(double));
+    CHECK(wide.adviseWillNeed({1, 5}, {3, 2}) == 3 * 2 * sizeof(double));
+    CHECK(wide.adviseWillNeed({1, 0}, {3, 1024}) == 3 * 1024 * sizeof(double));
+    CHECK(chunked.adviseWillNeed({0, 0}, {0, 0}) == 0);
+    CHECK_THROWS_AS(chunked.adviseWillNeed({0}, {1}), DataSetException);
+    CHECK_THROWS_AS(contiguous.adviseWillNeed({nx - 1, 0}, {2, ny}), DataSetException);
+    CHECK_THROWS_AS(chunked.adviseWillNeed({0, ny + 1}, {1, 0}), DataSetException);
+
+#if H5_VERSION_GE(1, 10, 5)
+    CHECK(chunked.adviseWillNeed() == nx * ny * sizeof(double));
+    // Touches the chunks (1, 0), (1, 1), (2, 0) and (2, 1).
+    CHECK(chunked.adviseWillNeed({15, 5}, {10, 10}) == 4 * 100 * sizeof(double));
+    CHECK(sparse.adviseWillNeed() == 10 * ny * sizeof(double));
+#endif
+
+    std::vector<double> result(10 * 10);
+    chunked.select({15, 5}, {10, 10}).read(result.data());
+    CHECK(result[0] == values[15 * ny + 5]);
+}
+
+TEST_CASE("forEachChunk") {
+    const std::string filename = "forEachChunk.h5";
+    const size_t nx = 25, ny = 17;
+
+    std::vector<int> values(nx * ny);
+    std::iota(values.begin(), values.end(), 0);
+
+    File file(filename, File::Truncate);
+    DataSetCreateProps props;
+    props.add(Chunking(std::vector<hsize_t>{10, 5}));
+
+    // Write the chunks last to first, to store them in reverse order.
+    auto chunked = file.createDataSet<int>("chunked", DataSpace({nx, ny}), props);
+    for (size_t i = 3; i-- > 0;) {
+        const size_t n_rows = std::min(size_t(10), nx - 10 * i);
+        chunked.select({10 * i, 0}, {n_rows, ny}).write_raw(values.data() + 10 * i * ny);
+    }
+    file.createDataSet<int>("contiguous", DataSpace({nx, ny})).write_raw(values.data());
+    auto sparse = file.createDataSet<int>("sparse", DataSpace({nx, ny}), props);
+    sparse.select({10, 5}, {10, 5}).write_raw(values.data());
+
+    std::vector<std::vector<size_t>> offsets;
+    std::vector<int> scanned(nx * ny, -1);
+    auto callback = [&](const std::vector<size_t>& offset,
+                        const std::vector<size_t>& count,
+                        const int* data) {
+        REQUIRE(offset.size() == 2);
+        CHECK(offset[0] + count[0] <= nx);
+        CHECK(offset[1] + count[1] <= ny);
+        offsets.push_back(offset);
+        for (size_t i = 0; i < count[0]; ++i) {
+            for (size_t j = 0; j < count[1]; ++j) {
+                scanned[(offset[0] + i) * ny + offset[1] + j] = data[i * count[1] + j];
+            }
+        }
+    };
+
+    CHECK(chunked.forEachChunk<int>(callback) == 3 * 4);
+    CHECK(scanned == values);
+#if H5_VERSION_GE(1, 10, 5)
+    CHECK(offsets.front()[0] == 20);
+    CHECK(offsets.back()[0] == 0);
+#else
+    CHECK(offsets.front()[0] == 0);
+    CHECK(offsets.back()[0] == 20);
+#endif
+
+#if H5_VERSION_GE(1, 10, 2)
+    offsets.clear();
+    CHECK(sparse.forEachChunk<int>(callback) == 1);
+    CHECK(offsets == std::vector<std::vector<size_t>>{{10, 5}});
+#endif
+
+    offsets.clear();
+    CHECK(file.getDataSet("contiguous").forEachChunk<int>(callback) == 1);
+    CHECK(offsets == std::vector<std::vector<size_t>>{{0, 0}});
+
+    SECTION("threads") {
+        std::mutex mutex;
+        std::fill(scanned.begin(), scanned.end(), -1);
+        auto locked_callback = [&](const std::vector<size_t>& offset,
+                                   const std::vector<size_t>& count,
+                                   const int* data) {
+            std::lock_guard<std::mutex> lock(mutex);
+            callback(offset, count, data);
+        };
+        CHECK(chunked.forEachChunk<int>(locked_callback, 3) == 3 * 4);
+        CHECK(scanned == values);
+
+        size_t n_calls = 0;
+        auto failing_callback =
+            [&](const std::vector<size_t>&, const std::vector<size_t>&, const int*) {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (++n_calls == 2) {
+                    throw std::runtime_error("stop");
+                }
+            };
+        CHECK_THROWS_AS(chunked.forEachChunk<int>(failing_callback, 3), std::runtime_error);
+        CHECK(n_calls < 3 * 4);
+    }
+}
+
+TEST_CASE("storageReport") {
+    const std::string filename = "storageReport.h5";
+    const size_t nx = 40, ny = 30;
+    const std::vector<double> values(nx * ny, 1.0);
+
+    File file(filename, File::Truncate);
+    DataSetCreateProps props;
+    props.add(Chunking(std::vector<hsize_t>{10, 10}));
+    props.add(Deflate(9));
+
+    auto compressed = file.createDataSet<double>("compressed", DataSpace({nx, ny}), props);
+    compressed.write_raw(values.data());
+    file.createDataSet<double>("group/contiguous", DataSpace({nx, ny})).write_raw(values.data());
+    file.createSoftLink("soft", compressed);
+    REQUIRE(H5Lcreate_hard(file.getId(), "compressed", file.getId(), "hard", H5P_DEFAULT,
+                           H5P_DEFAULT) >= 0);
+
+    // Interleave the chunks of two datasets, and only write the first 10 rows.
+    // Chunks are allocated when leaving the chunk cache, e.g. on flush.
+    DataSetCreateProps plain;
+    plain.add(Chunking(std::vector<hsize_t>{10, 10}));
+    auto sparse = file.createDataSet<double>("sparse", DataSpace({nx, ny}), plain);
+    auto other = file.createDataSet<double>("other", DataSpace({nx, ny}), plain);
+    for (size_t j = 0; j < ny; j += 10) {
+        sparse.select({0, j}, {10, 10}).write_raw(values.data());
+        file.flush();
+        other.select({0, j}, {10, 10}).write_raw(values.data());
+        file.flush();
+    }
+
+#if H5_VERSION_GE(1, 10, 5)
+    const auto table = compressed.getChunkInfo();
+    REQUIRE(table.size() == 12);
+    CHECK(table.n_dims == 2);
+    uint64_t total_size = 0;
+    for (size_t i = 0; i < table.size(); ++i) {
+        const auto offset = table.offset(i);
+        CHECK(offset[0] % 10 == 0);
+        CHECK(offset[1] % 10 == 0);
+        CHECK(table.filter_masks[i] == 0);
+        total_size += table.sizes[i];
+    }
+    CHECK(total_size == compressed.getStorageSize());
+    CHECK(sparse.getChunkInfo().size() == 3);
+    CHECK_THROWS_AS(file.getDataSet("group/contiguous").getChunkInfo(), DataSetException);
+
+    const auto report = compressed.getStorageReport();
+    CHECK(report.layout == H5D_CHUNKED);
+    CHECK(report.n_chunks == 12);
+    CHECK(report.n_allocated_chunks == 12);
+    CHECK(report.data_size == nx * ny * sizeof(double));
+    CHECK(report.allocated_size == report.data_size);
+    CHECK(report.compressionRatio() > 10.0);
+    CHECK(report.unallocatedFraction() == 0.0);
+
+    const auto sparse_report = sparse.getStorageReport();
+    CHECK(sparse_report.n_allocated_chunks == 3);
+    CHECK(sparse_report.unallocatedFraction() == 0.75);
+    CHECK(sparse_report.compressionRatio() == 1.0);
+    CHECK(sparse_report.n_extents == 3);
+    CHECK(sparse_report.fragmentation() > 0.4);
+
+    const auto reports = file.storageReport();
+    std::vector<std::string> paths;
+    for (const auto& r: reports) {
+        paths.push_back(r.path);
+    }
+    CHECK(paths ==
+          std::vector<std::string>{"/compressed", "/group/contiguous", "/other", "/sparse"});
+
+    const auto& contiguous = reports[1];
+    CHECK(contiguous.layout == H5D_CONTIGUOUS);
+    CHECK(contiguous.n_chunks == 1);
+    CHECK(contiguous.n_allocated_chunks == 1);
+    CHECK(contiguous.storage_size == nx * ny * sizeof(double));
+    CHECK(contiguous.compressionRatio() == 1.0);
+    CHECK(contiguous.fragmentation() == 0.0);
+#endif
+}
+
+TEST_CASE("readSparse and readDenseFill") {
+    const std::string filename = "readSparse.h5";
+    const size_t nx = 95, ny = 100;
+
+    File file(filename, File::Truncate);
+    DataSetCreateProps props;
+    props.add(Chunking(std::vector<hsize_t>{10, 10}));
+    auto zero = file.createDataSet<int>("zero", DataSpace({nx, ny}), props);
+    const int fill_value = -1;
+    REQUIRE(H5Pset_fill_value(props.getId(), H5T_NATIVE_INT, &fill_value) >= 0);
+    auto sparse = file.createDataSet<int>("sparse", DataSpace({nx, ny}), props);
+
+    std::vector<int> block(10 * 10);
+    std::iota(block.begin(), block.end(), 1);
+    for (auto* dataset: {&zero, &sparse}) {
+        dataset->select({50, 20}, {10, 10}).write_raw(block.data());
+        dataset->select({0, 0}, {10, 10}).write_raw(block.data());
+        dataset->select({90, 90}, {5, 10}).write_raw(block.data());
+    }
+
+#if H5_VERSION_GE(1, 10, 5)
+    const auto blocks = sparse.readSparse<int>();
+    REQUIRE(blocks.size() == 3);
+    CHECK(blocks[0].offset == std::vector<size_t>{0, 0});
+    CHECK(blocks[1].offset == std::vector<size_t>{50, 20});
+    CHECK(blocks[2].offset == std::vector<size_t>{90, 90});
+    CHECK(blocks[2].count == std::vector<size_t>{5, 10});
+    CHECK(blocks[1].data == block);
+    CHECK(blocks[2].data == std::vector<int>(block.begin(), block.begin() + 50));
+#endif
+
+    for (const auto* dataset: {&zero, &sparse}) {
+        std::vector<int> expected(nx * ny), result(nx * ny, 42);
+        dataset->read(expected.data());
+        dataset->readDenseFill(result.data());
+        CHECK(result == expected);
+    }
+    std::vector<int> values(nx * ny);
+    sparse.read(values.data());
+    CHECK(values[nx * ny - 1] == 50);
+    CHECK(values[nx * ny - 11] == -1);
+
+    DataSetCreateProps full_props;
+    full_props.add(Chunking(std::vector<hsize_t>{4}));
+    auto full = file.createDataSet<double>("full", DataSpace({15}), full_props);
+    std::vector<double> data(15, 2.0), result(15);
+    full.write(data);
+    full.readDenseFill(result.data());
+    CHECK(result == data);
+}
+
+TEST_CASE("Scanning many chunks") {
+    // Listing the chunks by index is quadratic before HDF5 1.14, this takes
+    // minutes instead of a fraction of a second if it creeps back in.
+    const std::string filename = "many_chunks.h5";
+    const size_t n_written = 100000;
+
+    File file(filename, File::Truncate);
+    DataSetCreateProps props;
+    props.add(Chunking(std::vector<hsize_t>{1}));
+    auto dataset = file.createDataSet<int>("dset", DataSpace({2 * n_written}), props);
+    std::vector<int> values(n_written);
+    std::iota(values.begin(), values.end(), 1);
+    dataset.select({n_written}, {n_written}).write_raw(values.data());
+    file.flush();
+
+    const auto start = std::chrono::steady_clock::now();
+
+#if H5_VERSION_GE(1, 10, 2)
+    size_t n_elements = 0;
+    CHECK(dataset.forEachChunk<int>([&n_elements](const std::vector<size_t>&,
+                                                  const std::vector<size_t>& count,
+                                                  const int*) { n_elements += count[0]; }) ==
+          n_written);
+    CHECK(n_elements == n_written);
+
+    const auto blocks = dataset.readSparse<int>();
+    REQUIRE(blocks.size() == n_written);
+    CHECK(blocks.front().offset == std::vector<size_t>{n_written});
+    CHECK(blocks.back().data == std::vector<int>{int(n_written)});
+#endif
+
+    std::vector<int> result(2 * n_written, 42);
+    dataset.readDenseFill(result.data());
+    CHECK(result[n_written - 1] == 0);
+    CHECK(result[n_written] == 1);
+    CHECK(result.back() == int(n_written));
+
+#if H5_VERSION_GE(1, 14, 0)
+    CHECK(dataset.getChunkInfo().size() == n_written);
+    CHECK(dataset.getStorageReport().n_allocated_chunks == n_written);
+#endif
+
+    CHECK(std::chrono::steady_clock::now() - start < std::chrono::seconds(30));
+}
+
+TEST_CASE("IOTrace") {
+    const std::string filename = "io_trace.h5";
+    const std::string trace_name = "io_trace.trace";
+
+    File file(filename, File::Truncate);
+    auto dataset = file.createDataSet<int>("group/dset", DataSpace({10, 8}));
+    std::vector<int> values(10 * 8, 1);
+
+    // Not traced.
+    dataset.write_raw(values.data());
+
+    IOTrace::start(trace_name);
+    CHECK(IOTrace::isActive());
+    dataset.write_raw(values.data());
+    dataset.select({2, 3}, {4, 5}).read<std::vector<std::vector<int>>>();
+    dataset.select(ElementSet({{1, 1}, {5, 2}})).read<std::vector<int>>();
+    dataset.select({0, 0}, {3, 2}, {3, 4}).read<std::vector<std::vector<int>>>();
+
+    // Same path, another file.
+    File other_file("io_trace_other.h5", File::Truncate);
+    auto other = other_file.createDataSet<int>("group/dset", DataSpace({3}));
+    other.write_raw(values.data());
+
+    // Failed accesses aren't traced.
+    {
+        SilenceHDF5 silence;
+        CHECK_THROWS_AS(dataset.read(values.data(), VariableLengthStringType()),
+                        DataSetException);
+    }
+    IOTrace::stop();
+    CHECK(!IOTrace::isActive());
+
+    // Not traced.
+    dataset.read<std::vector<std::vector<int>>>();
+
+    auto events = IOTrace::load(trace_name);
+    REQUIRE(events.size() == 5);
+
+    for (size_t i = 0; i < 4; ++i) {
+        CHECK(events[i].file == filename);
+        CHECK(events[i].dataset == "/group/dset");
+        CHECK(events[i].dataset_dims == std::vector<size_t>{10, 8});
+        CHECK(events[i].element_size == sizeof(int));
+    }
+
+    CHECK(events[0].operation == IOTrace::Operation::Write);
+    CHECK(events[0].n_elements == 80);
+    CHECK(events[0].offset == std::vector<size_t>{0, 0});
+    CHECK(events[0].count == std::vector<size_t>{10, 8});
+    CHECK(events[0].selection == IOTrace::SelectionType::All);
+
+    CHECK(events[1].operation == IOTrace::Operation::Read);
+    CHECK(events[1].n_elements == 20);
+    CHECK(events[1].offset == std::vector<size_t>{2, 3});
+    CHECK(events[1].count == std::vector<size_t>{4, 5});
+    CHECK(events[1].selection == IOTrace::SelectionType::Box);
+    CHECK(events[1].start >= events[0].start + events[0].duration);
+
+    CHECK(events[2].n_elements == 2);
+    CHECK(events[2].offset == std::vector<size_t>{1, 1});
+    CHECK(events[2].count == std::vector<size_t>{5, 2});
+    CHECK(events[2].selection == IOTrace::SelectionType::Points);
+
+    CHECK(events[3].n_elements == 6);
+    CHECK(events[3].offset == std::vector<size_t>{0, 0});
+    CHECK(events[3].count == std::vector<size_t>{7, 5});
+    CHECK(events[3].selection == IOTrace::SelectionType::Hyperslab);
+
+    CHECK(events[4].file == "io_trace_other.h5");
+    CHECK(events[4].dataset == "/group/dset");
+    CHECK(events[4].dataset_dims == std::vector<size_t>{3});
+
+    CHECK_THROWS_AS(IOTrace::load(filename), Exception);
+
+    // Datasets opened and closed over and over are only described once.
+    const size_t n_opened = 3 * details::max_traced_hids;
+    IOTrace::start(trace_name);
+    for (size_t i = 0; i < n_opened; ++i) {
+        file.getDataSet("group/dset").select({0, 0}, {1, 1}).read<std::vector<std::vector<int>>>();
+    }
+    CHECK(details::get_io_trace_state().ids_by_hid.size() <= details::max_traced_hids);
+    IOTrace::stop();
+
+    events = IOTrace::load(trace_name);
+    REQUIRE(events.size() == n_opened);
+    CHECK(events.back().dataset == "/group/dset");
+    CHECK(events.back().n_elements == 1);
+}
+
+TEST_CASE("Timeline") {
+    const std::string filename = "timeline.h5";
+    const std::string timeline_name = "timeline.json";
+
+    // Not recorded.
+    File(filename, File::Truncate).createGroup("untraced");
+
+    Timeline::start(timeline_name);
+    CHECK(Timeline::isActive());
+    {
+        File file(filename, File::ReadWrite);
+        auto group = file.createGroup("group");
+        group.createDataSet("dset", std::vector<int>{1, 2, 3});
+        group.createAttribute("attr", 42);
+        CHECK(group.getAttribute("attr").read<int>() == 42);
+        CHECK(group.exist("dset"));
+        group.getDataSet("dset");
+        file.getGroup("group").listObjectNames();
+        file.flush();
+    }
+    Timeline::stop();
+    CHECK(!Timeline::isActive());
+
+    // Not recorded.
+    File(filename, File::ReadOnly).getGroup("untraced");
+
+    std::ifstream in(timeline_name);
+    const std::string json((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+    CHECK(json.find("\"traceEvents\"") != std::string::npos);
+    for (const char* span: {"File::open",
+                            "File::close",
+                            "File::flush",
+                            "createGroup",
+                            "createDataSet",
+                            "getDataSet",
+                            "getGroup",
+                            "exist",
+                            "listObjectNames",
+                            "createAttribute",
+                            "getAttribute",
+                            "Attribute::read",
+                            "Attribute::write"}) {
+        CHECK(json.find("\"name\":\"" + std::string(span) + "\"") != std::string::npos);
+    }
+    CHECK(json.find("\"args\":{\"name\":\"dset\"}") != std::string::npos);
+    CHECK(json.find("untraced") == std::string::npos);
+
+    // The data version of `createDataSet` creates the dataset itself.
+    size_t n_create_dataset = 0;
+    for (size_t pos = json.find("createDataSet"); pos != std::string::npos;
+         pos = json.find("createDataSet", pos + 1)) {
+        ++n_create_dataset;
+    }
+    CHECK(n_create_dataset == 2);
+
+    CHECK_THROWS_AS(Timeline::start("no_such_directory/timeline.json"), Exception);
+    CHECK(!Timeline::isActive());
+}
+
+TEST_CASE("memoryReport") {
+    const std::string filename = "memory_report.h5";
+    const size_t n_rows = 100, n_cols = 10;
+
+    File file(filename, File::Truncate);
+    auto written = std::vector<std::vector<double>>(n_rows, std::vector<double>(n_cols, 1.0));
+    auto dataset = file.createDataSet("dset", written);
+    auto group = file.createGroup("group");
+
+    // Reading nested vectors goes through a staging buffer.
+    const size_t staging_size = memoryReport().staging_size;
+    dataset.read<std::vector<std::vector<double>>>();
+    auto report = memoryReport();
+    CHECK(report.staging_size == staging_size);
+#ifdef HIGHFIVE_TRACK_STAGING_MEMORY
+    CHECK(report.staging_peak_size >= n_rows * n_cols * sizeof(double));
+#else
+    CHECK(report.staging_peak_size == 0);
+#endif
+
+    auto it = std::find_if(report.files.begin(),
+                           report.files.end(),
+                           [&](const MemoryReport::FileMemory& f) { return f.name == filename; });
+    REQUIRE(it != report.files.end());
+    CHECK(it->metadata_cache_max_size > 0);
+    CHECK(it->metadata_cache_size > 0);
+    CHECK(it->metadata_cache_entries > 0);
+    CHECK(it->chunk_cache_size > 0);
+    CHECK(it->open_datasets == 1);
+    CHECK(it->open_groups == 1);
+    CHECK(it->open_attributes == 0);
+
+    FreeListLimits limits;
+    limits.regular_global = 1024 * 1024;
+    limits.block_global = 1024 * 1024;
+    CHECK_NOTHROW(setFreeListLimits(limits));
+    CHECK_NOTHROW(setFreeListLimits(FreeListLimits()));
+}
+
+TEST_CASE("FileCloseDegree") {
+    const std::string filename = "file_close_degree.h5";
+    File(filename, File::Truncate).createDataSet("dset", 42);
+
+    FileAccessProps fapl;
+    fapl.add(FileCloseDegree(H5F_CLOSE_STRONG));
+    CHECK(FileCloseDegree(fapl).getDegree() == H5F_CLOSE_STRONG);
+
+    // Strong close closes the objects along with the file.
+    std::unique_ptr<DataSet> dataset;
+    {
+        File file(filename, File::ReadOnly, fapl);
+        dataset.reset(new DataSet(file.getDataSet("dset")));
+        auto open_objects = file.getOpenObjects();
+        REQUIRE(open_objects.size() == 1);
+        CHECK(open_objects[0].type == ObjectType::Dataset);
+        CHECK(open_objects[0].path == "/dset");
+    }
+    CHECK(!dataset->isValid());
+
+    // By default, the dataset keeps the file open.
+    {
+        File file(filename, File::ReadOnly);
+        dataset.reset(new DataSet(file.getDataSet("dset")));
+    }
+    CHECK(dataset->isValid());
+    CHECK(dataset->read<int>() == 42);
+    CHECK(dataset->getFile().getOpenObjects().size() == 1);
+
+    // The handles returned by `getFile` keep the file open while they exist.
+    dataset.reset();
+    {
+        File file(filename, File::ReadOnly, fapl);
+        dataset.reset(new DataSet(file.getDataSet("dset")));
+        CHECK(dataset->getFile().getName() == filename);
+    }
+    CHECK(!dataset->isValid());
+
+    dataset.reset();
+    {
+        std::unique_ptr<File> dataset_file;
+        {
+            File file(filename, File::ReadOnly, fapl);
+            dataset.reset(new DataSet(file.getDataSet("dset")));
+            dataset_file.reset(new File(dataset->getFile()));
+        }
+        CHECK(dataset->isValid());
+        CHECK(dataset->read<int>() == 42);
+    }
+    CHECK(!dataset->isValid());
+
+    // Closing explicitly.
+    dataset.reset();
+    {
+        File file(filename, File::ReadOnly, fapl);
+        dataset.reset(new DataSet(file.getDataSet("dset")));
+        auto copy = file;
+        file.close();
+        CHECK(!file.isValid());
+        CHECK_NOTHROW(file.close());
+        CHECK(dataset->isValid());
+
+        copy.close();
+        CHECK(!dataset->isValid());
+    }
+
+    // Move assignment releases the previous handle and doesn't copy the other.
+    static_assert(std::is_nothrow_move_assignable<File>::value, "");
+    dataset.reset();
+    {
+        File file(filename, File::ReadOnly, fapl);
+        dataset.reset(new DataSet(file.getDataSet("dset")));
+        File other("file_close_degree_other.h5", File::Truncate);
+        const hid_t other_id = other.getId();
+        file = std::move(other);
+        CHECK(!dataset->isValid());
+        CHECK(file.getId() == other_id);
+        CHECK(file.getName() == "file_close_degree_other.h5");
+        CHECK(H5Iget_ref(other_id) == 1);
+    }
+}
+
+TEST_CASE("Open objects check") {
+    const std::string filename = "open_objects_check.h5";
+    std::vector<std::string> messages;
+    register_logging_callback(
+        [&messages](LogSeverity, const std::string& message, const std::string&, int) {
+            messages.push_back(message);
+        });
+
+    CHECK(!File::hasOpenObjectsCheck());
+    File::setOpenObjectsCheck(true);
+    CHECK(File::hasOpenObjectsCheck());
+
+    std::unique_ptr<Group> group;
+    {
+        File file(filename, File::Truncate);
+        file.createGroup("closed");
+        group.reset(new Group(file.createGroup("leaked")));
+    }
+    File::setOpenObjectsCheck(false);
+    register_logging_callback(&default_logging_callback);
+
+    if (HIGHFIVE_LOG_LEVEL <= int(LogSeverity::Warn)) {
+        REQUIRE(messages.size() == 1);
+        CHECK(messages[0].find(filename) != std::string::npos);
+        CHECK(messages[0].find("/leaked") != std::string::npos);
+        CHECK(messages[0].find("/closed") == std::string::npos);
+    }
+}
+
+TEST_CASE("MultiIO") {
+    const std::string filename = "multi_io.h5";
+
+    File file(filename, File::Truncate);
+    auto x = file.createDataSet<double>("x", DataSpace(10));
+    auto y = file.createDataSet<int>("y", DataSpace({4, 5}));
+
+    std::vector<double> x_values(10);
+    std::iota(x_values.begin(), x_values.end(), 0.5);
+    std::vector<int> y_values(6, 42);
+
+    MultiIO writes;
+    writes.add(x, x_values.data());
+    writes.add(y.select({1, 2}, {2, 3}), static_cast<const int*>(y_values.data()));
+    CHECK(writes.size() == 2);
+    writes.write();
+    CHECK_THROWS_AS(writes.read(), DataSetException);
+
+    std::vector<double> x_read(5);
+    std::vector<int> y_read(20);
+
+    MultiIO reads;
+    reads.add(x.select({5}, {5}), x_read.data());
+    reads.add(y, y_read.data());
+    reads.read();
+
+    CHECK(x_read == std::vector<double>(x_values.begin() + 5, x_values.end()));
+    for (size_t i = 0; i < 4; ++i) {
+        for (size_t j = 0; j < 5; ++j) {
+            bool written = i >= 1 && i < 3 && j >= 2;
+            CHECK(y_read[i * 5 + j] == (written ? 42 : 0));
+        }
+    }
+
+    reads.clear();
+    CHECK(reads.size() == 0);
+    reads.read();
+}
+
 template <typename T>
 void selectionArraySimpleTest() {
     typedef typename std::vector<T> Vector;
@@ -2478,6 +3478,233 @@ TEST_CASE("HighFiveRenameRelative") {
     }
 }
 
+TEST_CASE("HighFiveCopyTo") {
+    const std::string file_name("copy_to.h5");
+    const std::string other_file_name("copy_to_other.h5");
+
+    std::vector<int> data(100);
+    std::iota(data.begin(), data.end(), 0);
+
+    File file(file_name, File::Truncate);
+    {
+        auto group = file.createGroup("src/sub");
+        group.createDataSet("data", data);
+        group.createAttribute("answer", 42);
+        file.createSoftLink("src/link", group.getDataSet("data"));
+    }
+    auto src = file.getGroup("src");
+
+    SECTION("H5Ocopy") {
+        src.copyTo(file, "dst");
+        CHECK(file.getDataSet("dst/sub/data").read<std::vector<int>>() == data);
+        CHECK(file.getGroup("dst/sub").getAttribute("answer").read<int>() == 42);
+        CHECK(file.getLinkType("dst/link") == LinkType::Soft);
+
+        ObjectCopyProps copy_props;
+        copy_props.add(CopyObjectFlags(H5O_COPY_WITHOUT_ATTR_FLAG));
+        CHECK(CopyObjectFlags(copy_props).getFlags() == H5O_COPY_WITHOUT_ATTR_FLAG);
+
+        File other(other_file_name, File::Truncate);
+        src.copyTo(other, "a/b", copy_props);
+        CHECK(other.getDataSet("a/b/sub/data").read<std::vector<int>>() == data);
+        CHECK(!other.getGroup("a/b/sub").hasAttribute("answer"));
+    }
+
+    SECTION("repack") {
+        File other(other_file_name, File::Truncate);
+        src.copyTo(
+            other,
+            "repacked",
+            [](const DataSet&) {
+                DataSetCreateProps props;
+                props.add(Chunking(std::vector<hsize_t>{16}));
+                props.add(Deflate(9));
+                return props;
+            },
+            10 * sizeof(int));
+
+        auto dataset = other.getDataSet("repacked/sub/data");
+        auto dcpl = dataset.getCreatePropertyList();
+        CHECK(Chunking(dcpl).getDimensions() == std::vector<hsize_t>{16});
+        CHECK(dataset.read<std::vector<int>>() == data);
+        CHECK(other.getGroup("repacked/sub").getAttribute("answer").read<int>() == 42);
+        CHECK(other.getLinkType("repacked/link") == LinkType::Soft);
+    }
+
+    SECTION("repack with conversion") {
+        File other(other_file_name, File::Truncate);
+        RepackOptions options;
+        options.dataset_type = [](const DataSet&) { return create_datatype<double>(); };
+        src.copyTo(other, "converted", options);
+
+        auto dataset = other.getDataSet("converted/sub/data");
+        CHECK(dataset.getDataType() == create_datatype<double>());
+        CHECK(dataset.read<std::vector<double>>() == std::vector<double>(data.begin(), data.end()));
+    }
+
+    SECTION("repack with threads") {
+        // Edge chunks in both dimensions, and several slabs.
+        std::vector<std::vector<int>> matrix(37, std::vector<int>(23));
+        for (size_t i = 0; i < matrix.size(); ++i) {
+            std::iota(matrix[i].begin(), matrix[i].end(), int(i * 100));
+        }
+        file.createDataSet("src/matrix", matrix);
+
+        for (auto compress: {true, false}) {
+            File other(other_file_name, File::Truncate);
+            RepackOptions options;
+            options.dataset_props = [compress](const DataSet& dataset) {
+                DataSetCreateProps props;
+                if (dataset.getDimensions().size() == 2) {
+                    props.add(Chunking(std::vector<hsize_t>{8, 5}));
+                } else {
+                    props.add(Chunking(std::vector<hsize_t>{16}));
+                }
+                if (compress) {
+                    props.add(Shuffle());
+                    props.add(Deflate(6));
+                } else {
+                    // Not applied by HighFive, HDF5 compresses on the calling thread.
+                    H5Pset_fletcher32(props.getId());
+                }
+                return props;
+            };
+            options.buffer_size = 16 * 23 * sizeof(int);
+            options.n_threads = 4;
+            src.copyTo(other, "repacked", options);
+
+            auto dataset = other.getDataSet("repacked/matrix");
+            auto dcpl = dataset.getCreatePropertyList();
+            CHECK(H5Pget_nfilters(dcpl.getId()) == (compress ? 2 : 1));
+            CHECK(dataset.read<std::vector<std::vector<int>>>() == matrix);
+            CHECK(other.getDataSet("repacked/sub/data").read<std::vector<int>>() == data);
+        }
+    }
+}
+
+TEST_CASE("DeltaCheckpointer") {
+    File file("delta_checkpoint.h5", File::Truncate);
+
+    DataSetCreateProps dcpl;
+    dcpl.add(Chunking(std::vector<hsize_t>{4, 4}));
+    file.createDataSet<double>("state", DataSpace({10, 10}), dcpl);
+
+    std::vector<double> state(100);
+    std::iota(state.begin(), state.end(), 0.0);
+
+    {
+        auto checkpointer = DeltaCheckpointer(file, "state");
+        CHECK(checkpointer.getNumberChunks() == 9);
+        CHECK(checkpointer.write(state) == 9);
+        CHECK(checkpointer.write(state) == 0);
+
+        // Element (5, 5) lives in chunk (1, 1).
+        state[5 * 10 + 5] = -1.0;
+        CHECK(checkpointer.write(state) == 1);
+    }
+
+    // The hashes are persisted in the file.
+    auto checkpointer = DeltaCheckpointer(file, "state");
+    CHECK(checkpointer.write(state) == 0);
+    state[9 * 10 + 9] = -2.0;
+    state[0] = -3.0;
+    CHECK(checkpointer.write(state.data()) == 2);
+
+    auto read_back = std::vector<std::vector<double>>{};
+    file.getDataSet("state").read(read_back);
+    for (size_t i = 0; i < 10; ++i) {
+        for (size_t j = 0; j < 10; ++j) {
+            CHECK(read_back[i][j] == state[i * 10 + j]);
+        }
+    }
+
+    file.createDataSet<int>("contiguous", DataSpace({10}));
+    CHECK_THROWS_AS(DeltaCheckpointer(file, "contiguous"), DataSetException);
+}
+
+TEST_CASE("DeltaCheckpointerResize") {
+    File file("delta_checkpoint_resize.h5", File::Truncate);
+
+    DataSetCreateProps dcpl;
+    dcpl.add(Chunking(std::vector<hsize_t>{4, 4}));
+    auto dataset = file.createDataSet<double>(
+        "state", DataSpace({10, 10}, {DataSpace::UNLIMITED, DataSpace::UNLIMITED}), dcpl);
+
+    // All full chunks have the same content, hence the same hash.
+    auto checkpointer = DeltaCheckpointer(file, "state");
+    CHECK(checkpointer.write(std::vector<double>(10 * 10, 1.0), 3) == 9);
+
+    // The grid of chunks grows from 3 x 3 to 3 x 4. The last column of chunks
+    // is new, the one before it grows; the other chunks are unchanged.
+    dataset.resize({10, 16});
+    CHECK(checkpointer.getNumberChunks() == 12);
+    CHECK(checkpointer.write(std::vector<double>(10 * 16, 1.0), 3) == 6);
+    CHECK(checkpointer.write(std::vector<double>(10 * 16, 1.0), 3) == 0);
+
+    auto read_back = dataset.read<std::vector<std::vector<double>>>();
+    for (const auto& row: read_back) {
+        CHECK(row == std::vector<double>(16, 1.0));
+    }
+
+    // Shrinking the last dimension keeps the hashes of the remaining chunks.
+    dataset.resize({10, 8});
+    CHECK(checkpointer.write(std::vector<double>(10 * 8, 1.0)) == 0);
+    CHECK(DeltaCheckpointer(file, "state").write(std::vector<double>(10 * 8, 1.0)) == 0);
+}
+
+TEST_CASE("CheckpointFile") {
+    const std::string prefix("checkpoint_file");
+    std::remove((prefix + ".manifest").c_str());
+    std::remove((prefix + ".0.h5").c_str());
+    std::remove((prefix + ".1.h5").c_str());
+
+    auto write_checkpoint = [](CheckpointFile& checkpoint, int value) {
+        auto file = checkpoint.beginCheckpoint();
+        auto dset = file.exist("x") ? file.getDataSet("x")
+                                    : file.createDataSet<int>("x", DataSpace::From(value));
+        dset.write(value);
+        checkpoint.commit(file);
+    };
+
+    {
+        auto checkpoint = CheckpointFile(prefix);
+        CHECK(!checkpoint.hasCheckpoint());
+        CHECK_THROWS_AS(checkpoint.getLatestPath(), FileException);
+
+        write_checkpoint(checkpoint, 1);
+        CHECK(checkpoint.getLatestPath() == prefix + ".0.h5");
+        write_checkpoint(checkpoint, 2);
+        CHECK(checkpoint.getLatestPath() == prefix + ".1.h5");
+        CHECK(checkpoint.openLatest().getDataSet("x").read<int>() == 2);
+    }
+
+    // The state survives reopening, and the layout of older files is reused.
+    auto checkpoint = CheckpointFile(prefix);
+    CHECK(checkpoint.openLatest().getDataSet("x").read<int>() == 2);
+    {
+        auto file = checkpoint.beginCheckpoint();
+        CHECK(file.getName() == prefix + ".0.h5");
+        CHECK(file.exist("x"));
+        file.getDataSet("x").write(3);
+        // Not committed, the latest checkpoint must be unaffected.
+    }
+    CHECK(checkpoint.openLatest().getDataSet("x").read<int>() == 2);
+
+    write_checkpoint(checkpoint, 4);
+    CHECK(CheckpointFile(prefix).openLatest().getDataSet("x").read<int>() == 4);
+
+    // Only the file returned by `beginCheckpoint` can be committed.
+    {
+        auto file = checkpoint.beginCheckpoint();
+        auto latest = checkpoint.openLatest();
+        CHECK_THROWS_AS(checkpoint.commit(latest), FileException);
+        CHECK(checkpoint.getLatestPath() == prefix + ".0.h5");
+        checkpoint.commit(file);
+        CHECK(checkpoint.getLatestPath() == prefix + ".1.h5");
+    }
+    CHECK(std::ifstream(prefix + ".manifest.tmp").fail());
+}
+
 TEST_CASE("HighFivePropertyObjects") {
     const auto& plist1 = FileCreateProps::Default();  // get const-ref, otherwise copies
     CHECK(plist1.getId() == H5P_DEFAULT);
@@ -3441,6 +4668,123 @@ TEST_CASE("Logging") {
     }
 }
 
+// The time of the rate limit of the logger, see `Logger::set_clock`.
+static int64_t log_clock_now = 0;
+
+TEST_CASE("Logging level and rate limit") {
+    std::vector<std::string> messages;
+    register_logging_callback(
+        [&messages](LogSeverity, const std::string& message, const std::string&, int) {
+            messages.push_back(message);
+        });
+    auto& logger = get_global_logger();
+
+    // Disabled messages aren't formatted.
+    size_t n_formatted = 0;
+    auto format = [&n_formatted]() {
+        ++n_formatted;
+        return std::string("formatted");
+    };
+    logger.set_level(LogSeverity::Error);
+    CHECK(!logger.is_enabled(LogSeverity::Warn));
+    HIGHFIVE_LOG_WARN(format());
+    CHECK(n_formatted == 0);
+    CHECK(messages.empty());
+    logger.set_level(LogSeverity(HIGHFIVE_LOG_LEVEL));
+
+    if (HIGHFIVE_LOG_LEVEL <= int(LogSeverity::Warn)) {
+        logger.set_clock([]() { return log_clock_now; });
+        logger.set_rate_limit(5);
+        for (int i = 0; i < 20; ++i) {
+            HIGHFIVE_LOG_WARN(format());
+        }
+        CHECK(n_formatted == 5);
+        CHECK(messages.size() == 5);
+
+        // The next window reports the dropped messages.
+        log_clock_now += 1100000000;
+        HIGHFIVE_LOG_WARN("again");
+        REQUIRE(messages.size() == 6);
+        CHECK(messages.back() == "again");
+
+        messages.clear();
+        for (int window = 0; window < 2; ++window) {
+            if (window > 0) {
+                log_clock_now += 1100000000;
+            }
+            for (int i = 0; i < 20; ++i) {
+                HIGHFIVE_LOG_WARN("same site");
+            }
+        }
+        REQUIRE(messages.size() == 10);
+        CHECK(messages[5] == "same site [15 similar messages suppressed]");
+
+        logger.set_rate_limit(0);
+        messages.clear();
+        for (int i = 0; i < 20; ++i) {
+            HIGHFIVE_LOG_WARN("unlimited");
+        }
+        CHECK(messages.size() == 20);
+
+        // Call sites can have a limit of their own.
+        messages.clear();
+        for (int i = 0; i < 20; ++i) {
+            HIGHFIVE_LOG_WARN_LIMITED(2, "limited");
+        }
+        CHECK(messages.size() == 2);
+        logger.set_clock(nullptr);
+    }
+
+    logger.set_rate_limit(HIGHFIVE_LOG_RATE_LIMIT);
+    register_logging_callback(&default_logging_callback);
+}
+
+TEST_CASE("AsyncLogSink") {
+    std::mutex mutex;
+    std::vector<std::string> messages;
+    auto downstream =
+        [&mutex, &messages](LogSeverity, const std::string& message, const std::string&, int) {
+            std::lock_guard<std::mutex> lock(mutex);
+            messages.push_back(message);
+        };
+    auto n_messages = [&mutex, &messages]() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return messages.size();
+    };
+
+    {
+        AsyncLogSink sink(downstream, std::chrono::milliseconds(10));
+        auto callback = sink.callback();
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([&callback, t]() {
+                for (int i = 0; i < 100; ++i) {
+                    callback(LogSeverity::Warn, std::to_string(t), __FILE__, __LINE__);
+                }
+            });
+        }
+        for (auto& thread: threads) {
+            thread.join();
+        }
+        callback(LogSeverity::Warn, "last", __FILE__, __LINE__);
+        sink.flush();
+        REQUIRE(n_messages() == 401);
+        CHECK(messages.back() == "last");
+
+        // Passed on by the background thread.
+        callback(LogSeverity::Warn, "background", __FILE__, __LINE__);
+        for (int i = 0; i < 500 && n_messages() < 402; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        CHECK(n_messages() == 402);
+    }
+
+    // Every message is passed on exactly once.
+    for (int t = 0; t < 4; ++t) {
+        CHECK(std::count(messages.begin(), messages.end(), std::to_string(t)) == 100);
+    }
+}
+
 #define HIGHFIVE_STRINGIFY_VALUE(s) HIGHFIVE_STRINGIFY_NAME(s)
 #define HIGHFIVE_STRINGIFY_NAME(s)  #s
 
@@ -17,6 +17,9 @@
 #include <highfive/H5DataSet.hpp>
 #include <highfive/H5DataSpace.hpp>
 #include <highfive/H5Group.hpp>
+#include <highfive/H5MetadataSnapshot.hpp>
+#include <highfive/H5NodeShared.hpp>
+#include <highfive/H5ParallelRead.hpp>
 
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/catch_template_test_macros.hpp>
@@ -155,6 +158,109 @@ TEMPLATE_LIST_TEST_CASE("mpiSelectionArraySimpleCollectiveMD", "[template]", num
     selectionArraySimpleTestParallelCollectiveMDProps<TestType>();
 }
 
+TEST_CASE("mpiReadRedistributed") {
+    int mpi_rank, mpi_size;
+    MPI_Comm_size(MPI_COMM_WORLD, &mpi_size);
+    MPI_Comm_rank(MPI_COMM_WORLD, &mpi_rank);
+
+    const auto rank = static_cast<size_t>(mpi_rank);
+    const auto size = static_cast<size_t>(mpi_size);
+    const size_t n_rows = 5 * size + 3, n_cols = 2 * size + 1;
+
+    auto fapl = FileAccessProps{};
+    fapl.add(MPIOFileAccess(MPI_COMM_WORLD, MPI_INFO_NULL));
+    File file("h5_read_redistributed_parallel.h5", File::Truncate, fapl);
+
+    DataSetCreateProps dcpl;
+    dcpl.add(Chunking(std::vector<hsize_t>{4, n_cols}));
+    auto dataset = file.createDataSet<int>("x", DataSpace({n_rows, n_cols}), dcpl);
+
+    auto xfer_props = DataTransferProps{};
+    xfer_props.add(UseCollectiveIO{});
+
+    // Written by rows.
+    {
+        size_t begin = n_rows * rank / size, end = n_rows * (rank + 1) / size;
+        std::vector<int> values((end - begin) * n_cols);
+        for (size_t i = 0; i < values.size(); ++i) {
+            values[i] = static_cast<int>(begin * n_cols + i);
+        }
+        dataset.select({begin, 0}, {end - begin, n_cols}).write_raw(values.data(), xfer_props);
+    }
+
+    // Read by columns, skipping the first row.
+    size_t begin = n_cols * rank / size, end = n_cols * (rank + 1) / size;
+    auto offset = std::vector<size_t>{1, begin};
+    auto count = std::vector<size_t>{n_rows - 1, end - begin};
+
+    auto values = readRedistributed<int>(dataset, offset, count, MPI_COMM_WORLD, xfer_props);
+    REQUIRE(values.size() == count[0] * count[1]);
+    for (size_t i = 0; i < count[0]; ++i) {
+        for (size_t j = 0; j < count[1]; ++j) {
+            CHECK(values[i * count[1] + j] ==
+                  static_cast<int>((offset[0] + i) * n_cols + offset[1] + j));
+        }
+    }
+}
+
+TEST_CASE("mpiNodeSharedDataSet") {
+    int mpi_size;
+    MPI_Comm_size(MPI_COMM_WORLD, &mpi_size);
+
+    const size_t n = 10 * static_cast<size_t>(mpi_size) + 7;
+
+    auto fapl = FileAccessProps{};
+    fapl.add(MPIOFileAccess(MPI_COMM_WORLD, MPI_INFO_NULL));
+    File file("h5_node_shared_parallel.h5", File::Truncate, fapl);
+
+    std::vector<double> values(n);
+    for (size_t i = 0; i < n; ++i) {
+        values[i] = 0.5 * static_cast<double>(i);
+    }
+    file.createDataSet("table", values);
+
+    NodeSharedDataSet<double> table(file.getDataSet("table"), MPI_COMM_WORLD);
+    REQUIRE(table.size() == n);
+    CHECK(table.getDimensions() == std::vector<size_t>{n});
+    CHECK(std::vector<double>(table.begin(), table.end()) == values);
+
+    auto moved = std::move(table);
+    CHECK(table.size() == 0);
+    CHECK(moved[n - 1] == values[n - 1]);
+}
+
+TEST_CASE("mpiMetadataSnapshot") {
+    int mpi_rank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &mpi_rank);
+
+    auto fapl = FileAccessProps{};
+    fapl.add(MPIOFileAccess(MPI_COMM_WORLD, MPI_INFO_NULL));
+    fapl.add(MPIOCollectiveMetadata{});
+    File file("h5_metadata_snapshot_parallel.h5", File::Truncate, fapl);
+
+    file.createAttribute("version", 3);
+    auto group = file.createGroup("a/b");
+    auto dataset = group.createDataSet<double>("x", DataSpace({100, 3}));
+    dataset.createAttribute("units", std::vector<std::string>{"m", "s", "kg"});
+    file.createSoftLink("x", dataset);
+    file.flush();
+
+    // Only rank 0 reads the metadata, despite collective metadata reads.
+    auto snapshot = createMetadataSnapshot(file, MPI_COMM_WORLD, 0);
+
+    CHECK(snapshot.listObjectNames() == std::vector<std::string>{"a", "x"});
+    CHECK(snapshot.getAttribute("version").read<int>() == 3);
+    CHECK(snapshot.getLinkType("x") == LinkType::Soft);
+
+    auto copy = snapshot.getDataSet("/a/b/x");
+    CHECK(copy.getDimensions() == std::vector<size_t>{100, 3});
+    CHECK(copy.getDataType() == create_datatype<double>());
+    CHECK(copy.getAttribute("units").read<std::vector<std::string>>() ==
+          std::vector<std::string>{"m", "s", "kg"});
+
+    CHECK_THROWS_AS(createMetadataSnapshot("h5_metadata_snapshot_missing.h5", MPI_COMM_WORLD),
+                    FileException);
+}
 
 int main(int argc, char* argv[]) {
     MpiFixture mpi(argc, argv);